@@ -0,0 +1,384 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "Benchmark.hpp"
+#include "../Core/BufferPool.hpp"
+#include "../Core/DropThread.hpp"
+#include "../Core/ImageLimits.hpp"
+#include "../Core/Resampler.hpp"
+#include "../Core/ResizeJob.hpp"
+#include "../Core/ResizeOptions.hpp"
+#include "../Core/ResizeParameters.hpp"
+#include "../Core/ResizeThread.hpp"
+#include <QBuffer>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QJsonArray>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QUrl>
+#include <algorithm>
+#include <cmath>
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+//
+//  Benchmark
+//
+// Constructor
+//
+
+Benchmark::Benchmark(const QString& directory, int iterations, bool quick)
+    : Directory(directory)
+    , Iterations(iterations)
+    , Quick(quick)
+{
+}
+
+//
+//  run
+//
+// Generate the pictures, then run the measurements. The report holds the environment, the pictures,
+// the result of each measurement and the peak memory of the process
+//
+
+bool Benchmark::run(QJsonObject* report, QString* error)
+{
+    (*report)["qt"]         = QString(qVersion());
+    (*report)["cores"]      = QThread::idealThreadCount();
+    (*report)["iterations"] = this->Iterations;
+    (*report)["quick"]      = this->Quick;
+    if (!prepare(report, error)) {
+        return false;
+    }
+
+    (*report)["probe"]       = measureProbe();
+    (*report)["stages"]      = measureStages();
+    (*report)["resize"]      = measureResize();
+    (*report)["peak_rss_kb"] = peakRss();
+    return true;
+}
+
+//
+//  prepare
+//
+// Write the generated pictures. Formats without a writer are listed as skipped, so the report tells why they're missing
+//
+
+bool Benchmark::prepare(QJsonObject* report, QString* error)
+{
+    QList<QByteArray>     Writable = QImageWriter::supportedImageFormats();
+    QList<SyntheticImage> Catalog  = SyntheticImages::catalog(this->Quick);
+    QJsonArray            Pictures;
+    QJsonArray            Skipped;
+
+    for (int i = 0; i < Catalog.count(); i++) {
+        const SyntheticImage& Image = Catalog.at(i);
+        if (!Writable.contains(Image.Format)) {
+            Skipped << Image.name();
+            continue;
+        }
+
+        QString Filename = QDir(this->Directory).filePath(Image.name());
+        QImage  Picture  = SyntheticImages::generate(Image.Size, Image.Depth, SYNTHETIC_IMAGE_SEED + i);
+        if (Picture.isNull() || !QImageWriter(Filename, Image.Format).write(Picture)) {
+            *error = QString("Couldn't write %1").arg(Filename);
+            return false;
+        }
+
+        BenchFile File {Image, Filename, QFileInfo(Filename).size()};
+        this->Files << File;
+        Pictures << QJsonObject {{"name", Image.name()}, {"width", Image.Size.width()}, {"height", Image.Size.height()}, {"bytes", File.Bytes}};
+    }
+
+    (*report)["files"]   = Pictures;
+    (*report)["skipped"] = Skipped;
+    return true;
+}
+
+//
+//  measureProbe
+//
+// Probe all the pictures with the drop thread, as when they are dropped into the UI.
+// The latency of a file is the time between the start of its probe and the start of the next one.
+// Signals are connected directly, so they are timestamped in the drop thread, without event loop
+//
+
+QJsonObject Benchmark::measureProbe()
+{
+    DropThread*     Prober = DropThread::instance();
+    QElapsedTimer   Timer;
+    QVector<qint64> Stamps;
+    QVector<qint64> Latencies;
+    qint64          Elapsed = 0;
+    qint64          Pixels  = 0;
+
+    QMetaObject::Connection Started  = QObject::connect(Prober, &DropThread::processingDroppedFile, Prober, [&]() { Stamps << Timer.nsecsElapsed(); }, Qt::DirectConnection);
+    QMetaObject::Connection Finished = QObject::connect(Prober, &DropThread::dropProcessTerminaded, Prober, [&]() { Stamps << Timer.nsecsElapsed(); }, Qt::DirectConnection);
+
+    QList<QUrl> Urls;
+    for (const BenchFile& File : this->Files) {
+        Urls << QUrl::fromLocalFile(File.Filename);
+    }
+
+    Prober->setLimits(ImageLimits());
+    for (int i = 0; i < this->Iterations; i++) {
+        Stamps.clear();
+        Timer.start();
+        Prober->drop(Urls);
+        Prober->wait();
+        Elapsed += Stamps.last();
+        for (int j = 1; j < Stamps.count(); j++) {
+            Latencies << Stamps.at(j) - Stamps.at(j - 1);
+        }
+
+        // Discard the result, as the UI would consume it
+        QList<QPair<QString, QSize>> Result;
+        QStringList                  Oversized;
+        Prober->result(&Result, &Oversized);
+        for (const QPair<QString, QSize>& File : Result) {
+            Pixels += qint64(File.second.width()) * File.second.height();
+        }
+    }
+
+    QObject::disconnect(Started);
+    QObject::disconnect(Finished);
+    DropThread::release();
+
+    QJsonObject Probe    = statistics(Latencies, Elapsed, Pixels);
+    Probe["peak_rss_kb"] = peakRss();
+    return Probe;
+}
+
+//
+//  measureStages
+//
+// Run each stage of the engine on each picture, in the calling thread: read the file, decode it from memory
+// (into a pooled buffer, like the engine), resample it to half its size, encode it in its format, and write it.
+// Results are given per picture, as a mix of sizes and formats would hide where the time goes
+//
+
+QJsonObject Benchmark::measureStages()
+{
+    enum {
+        StageRead,
+        StageDecode,
+        StageResample,
+        StageEncode,
+        StageWrite,
+        StageCount,
+    };
+    static const char* StageNames[StageCount] = {"read", "decode", "resample", "encode", "write"};
+
+    ResizeOptions    Options;
+    ResizeParameters Parameters;
+    QDir(this->Directory).mkpath("stages");
+    QJsonObject Stages;
+
+    for (const BenchFile& File : this->Files) {
+        QVector<qint64> Latencies[StageCount];
+        qint64          Elapsed[StageCount] = {};
+        QElapsedTimer   Timer;
+        QString         Output = QDir(this->Directory).filePath("stages/" + File.Image.name());
+
+        for (int i = 0; i < this->Iterations; i++) {
+            // Read
+            Timer.start();
+            QFile Input(File.Filename);
+            Input.open(QIODevice::ReadOnly);
+            QByteArray Data = Input.readAll();
+            Input.close();
+            Latencies[StageRead] << Timer.nsecsElapsed();
+
+            // Decode
+            Timer.start();
+            QImage Image;
+            {
+                QBuffer        Buffer(&Data);
+                QImageReader   Reader(&Buffer, File.Image.Format);
+                QSize          Size        = Reader.size();
+                QImage::Format ImageFormat = Reader.imageFormat();
+                if (Size.isValid() && (ImageFormat != QImage::Format_Invalid)) {
+                    Image = BufferPool::instance()->image(Size, ImageFormat);
+                }
+                Reader.read(&Image);
+            }
+            Latencies[StageDecode] << Timer.nsecsElapsed();
+
+            // Resample
+            Timer.start();
+            QImage Resized = Resampler::resize(Image, Parameters.newSize(Image.size()), Options.Filter);
+            Latencies[StageResample] << Timer.nsecsElapsed();
+
+            // Encode
+            Timer.start();
+            QByteArray Encoded;
+            {
+                QBuffer Buffer(&Encoded);
+                Buffer.open(QIODevice::WriteOnly);
+                QImageWriter(&Buffer, File.Image.Format).write(Resized);
+            }
+            Latencies[StageEncode] << Timer.nsecsElapsed();
+
+            // Write
+            Timer.start();
+            QFile Result(Output);
+            Result.open(QIODevice::WriteOnly | QIODevice::Truncate);
+            Result.write(Encoded);
+            Result.close();
+            Latencies[StageWrite] << Timer.nsecsElapsed();
+        }
+
+        // Throughputs are given in source pixels for every stage, so they can be compared
+        qint64      Pixels = qint64(File.Image.Size.width()) * File.Image.Size.height() * this->Iterations;
+        QJsonObject Picture;
+        for (int Stage = 0; Stage < StageCount; Stage++) {
+            for (qint64 Latency : Latencies[Stage]) {
+                Elapsed[Stage] += Latency;
+            }
+            Picture[StageNames[Stage]] = statistics(Latencies[Stage], Elapsed[Stage], Pixels);
+        }
+        Stages[File.Image.name()] = Picture;
+    }
+
+    Stages["peak_rss_kb"] = peakRss();
+    return Stages;
+}
+
+//
+//  measureResize
+//
+// Resize copies of all the pictures with the resize thread, with the default engine settings.
+// The latency of a file is the time between the start of its job and its result, waits between the stages included.
+// Signals are emitted by the workers and connected directly, so the timestamps are shared under a mutex
+//
+
+QJsonObject Benchmark::measureResize()
+{
+    ResizeThread*    Resizer = ResizeThread::instance();
+    ResizeOptions    Options;
+    ResizeParameters Parameters;
+    QElapsedTimer    Timer;
+    QMutex           Mutex;
+    QVector<qint64>  Starts(this->Files.count(), 0);
+    QVector<qint64>  Latencies;
+    qint64           Elapsed  = 0;
+    qint64           Pixels   = 0;
+    int              Failures = 0;
+
+    // Workers record the start of their job, then its latency
+    auto onStarted = [&](int id) {
+        QMutexLocker Locker(&Mutex);
+        Starts[id] = Timer.nsecsElapsed();
+    };
+    auto onFinished = [&](int id, bool success) {
+        QMutexLocker Locker(&Mutex);
+        Latencies << Timer.nsecsElapsed() - Starts.at(id);
+        Failures += success ? 0 : 1;
+    };
+    QMetaObject::Connection Started  = QObject::connect(Resizer, &ResizeThread::resizingFile, Resizer, onStarted, Qt::DirectConnection);
+    QMetaObject::Connection Finished = QObject::connect(Resizer, &ResizeThread::fileResized, Resizer, onFinished, Qt::DirectConnection);
+
+    QDir(this->Directory).mkpath("resize");
+    for (int i = 0; i < this->Iterations; i++) {
+        // Files are overwritten by the resizing process, so each iteration works on fresh copies
+        QList<ResizeJob> Jobs;
+        for (int j = 0; j < this->Files.count(); j++) {
+            const BenchFile& File = this->Files.at(j);
+            QString          Copy = QDir(this->Directory).filePath("resize/" + File.Image.name());
+            QFile::remove(Copy);
+            QFile::copy(File.Filename, Copy);
+            Jobs << ResizeJob {j, Copy, File.Image.Size, Parameters.newSize(File.Image.Size)};
+            Pixels += qint64(File.Image.Size.width()) * File.Image.Size.height();
+        }
+
+        Timer.start();
+        Resizer->resize(Jobs, Options);
+        Resizer->wait();
+        Elapsed += Timer.nsecsElapsed();
+    }
+
+    QObject::disconnect(Started);
+    QObject::disconnect(Finished);
+    ResizeThread::release();
+
+    QJsonObject Resize    = statistics(Latencies, Elapsed, Pixels);
+    Resize["failures"]    = Failures;
+    Resize["peak_rss_kb"] = peakRss();
+    return Resize;
+}
+
+//
+//  statistics
+//
+// Throughput and latency percentiles (nearest rank) of a measurement. Times are given in ns, reported in ms
+//
+
+QJsonObject Benchmark::statistics(QVector<qint64> latencies, qint64 elapsed, qint64 pixels)
+{
+    std::sort(latencies.begin(), latencies.end());
+    int    Count   = latencies.count();
+    double Seconds = elapsed / 1e9;
+
+    auto percentile = [&](int percent) {
+        if (Count == 0) {
+            return 0.0;
+        }
+        int Index = qBound(0, int(std::ceil(percent * Count / 100.0)) - 1, Count - 1);
+        return latencies.at(Index) / 1e6;
+    };
+
+    QJsonObject Latency {{"p50", percentile(50)}, {"p90", percentile(90)}, {"p99", percentile(99)}, {"max", percentile(100)}};
+    QJsonObject Statistics;
+    Statistics["samples"]               = Count;
+    Statistics["elapsed_ms"]            = elapsed / 1e6;
+    Statistics["files_per_second"]      = Seconds > 0 ? Count / Seconds : 0.0;
+    Statistics["megapixels_per_second"] = Seconds > 0 ? pixels / 1e6 / Seconds : 0.0;
+    Statistics["latency_ms"]            = Latency;
+    return Statistics;
+}
+
+//
+//  peakRss
+//
+// Peak resident memory of the process, in kB. It never decreases, so the value reported after each measurement
+// is the peak of everything run so far
+//
+
+qint64 Benchmark::peakRss()
+{
+#ifdef Q_OS_UNIX
+    struct rusage Usage;
+    if (getrusage(RUSAGE_SELF, &Usage) == 0) {
+#ifdef Q_OS_MACOS
+        return Usage.ru_maxrss / 1024;
+#else
+        return Usage.ru_maxrss;
+#endif
+    }
+#endif
+    return 0;
+}
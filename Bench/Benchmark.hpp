@@ -0,0 +1,88 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include "SyntheticImages.hpp"
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+//
+//  BenchFile
+//
+// A generated picture written to the benchmark directory
+//
+
+struct BenchFile
+{
+    SyntheticImage Image;    // Description of the picture
+    QString        Filename; // Generated file
+    qint64         Bytes;    // Size of the file
+};
+
+//
+//  Benchmark
+//
+// This class measures the engine on generated pictures, without display nor network:
+//   - probe:  the drop thread reading the picture headers, as when files are dropped
+//   - stages: read, decode, resample, encode and write of each picture, measured on their own in the calling thread
+//   - resize: a whole resizing process of the resize thread, with its thread pools
+// Each measurement gives its throughput (files/s, Mpx/s of source pictures) and its latency percentiles.
+// Files are read from the page cache: the benchmark measures the engine, not the disk
+//
+
+class Benchmark
+{
+  public:
+    Benchmark(const QString& directory, int iterations, bool quick);
+    bool run(QJsonObject* report, QString* error); // Generate the pictures and run all the measurements. Return false if the pictures couldn't be written
+
+  private:
+    bool               prepare(QJsonObject* report, QString* error);                         // Write the generated pictures to the benchmark directory
+    QJsonObject        measureProbe();                                                       // Probe all the pictures with the drop thread
+    QJsonObject        measureStages();                                                      // Run each stage on each picture
+    QJsonObject        measureResize();                                                      // Resize copies of all the pictures with the resize thread
+    static QJsonObject statistics(QVector<qint64> latencies, qint64 elapsed, qint64 pixels); // Throughput and latency percentiles of a measurement. Times are in ns
+    static qint64      peakRss();                                                            // Peak resident memory of the process, in kB. 0 if unknown
+
+    QString          Directory;  // Directory holding the generated pictures and the resized copies
+    int              Iterations; // Number of times each measurement is repeated
+    bool             Quick;      // Skip the largest pictures
+    QList<BenchFile> Files;      // Generated pictures
+};
+
+//
+//  Exit codes of the benchmark
+//
+
+#define BENCH_EXIT_SUCCESS 0
+#define BENCH_EXIT_FAILURE 1
+#define BENCH_EXIT_USAGE 2
+
+//
+//  Default number of iterations of each measurement
+//
+
+#define BENCH_DEFAULT_ITERATIONS 3
+
+#endif // BENCHMARK_HPP
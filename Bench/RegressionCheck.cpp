@@ -0,0 +1,354 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "RegressionCheck.hpp"
+#include "SyntheticImages.hpp"
+#include "../Core/ErrorLog.hpp"
+#include "../Core/ResizeEngine.hpp"
+#include "../Core/ResizeJob.hpp"
+#include "../Core/ResizeOptions.hpp"
+#include <QDir>
+#include <QFile>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QList>
+#include <QMap>
+#include <QRgba64>
+#include <QSize>
+#include <QTemporaryDir>
+#include <cmath>
+
+//
+//  checkGolden
+//
+// Resize pictures of each depth with each resizing method and filter, through the whole engine: the file is read, decoded,
+// resampled, encoded and written like in a real batch, so every path of the resampler and of the codecs is exercised.
+// The source pictures are stored with the references, so the check doesn't depend on the generator:
+// with update, they are generated and written, then the results are written as references.
+// Otherwise, the results are compared to the references of the directory.
+// The references are only meaningful for the Qt build which wrote them: update records its version and image plugins
+// in GOLDEN_MANIFEST, and the check reports a mismatch. A directory without manifest fails the check
+//
+
+bool RegressionCheck::checkGolden(const QString& directory, bool update, QJsonObject* report)
+{
+    const QList<QImage::Format>    Depths {QImage::Format_Grayscale8, QImage::Format_RGB888, QImage::Format_ARGB32, QImage::Format_RGBA64};
+    const QList<Resampler::Filter> Filters {Resampler::FilterBox, Resampler::FilterTriangle, Resampler::FilterLanczos3};
+    const QSize                    OrgSize(GOLDEN_IMAGE_WIDTH, GOLDEN_IMAGE_HEIGHT);
+    QDir                           Directory(directory);
+    QTemporaryDir                  Temporary;
+    QJsonArray                     Results;
+    int                            Failures = 0;
+
+    // Integer and fractional downscaling, and upscaling
+    QList<ResizeParameters> Methods;
+    Methods << ResizeParameters(ResizeParameters::MethodPercentage, 50);
+    Methods << ResizeParameters(ResizeParameters::MethodPercentage, 37);
+    Methods << ResizeParameters(ResizeParameters::MethodAbsoluteSize, 50, 100);
+    Methods << ResizeParameters(ResizeParameters::MethodAbsoluteSize, 50, 200);
+
+    if ((update && !Directory.mkpath(".")) || !Temporary.isValid()) {
+        (*report)["golden"] = QJsonObject {{"directory", directory}, {"error", "Couldn't create the directory"}};
+        return false;
+    }
+
+    QJsonObject Golden;
+    QJsonObject Current = environment();
+    if (update) {
+        QFile::remove(Directory.filePath(GOLDEN_MANIFEST));
+    }
+    else {
+        QFile       File(Directory.filePath(GOLDEN_MANIFEST));
+        QJsonObject Manifest = File.open(QIODevice::ReadOnly) ? QJsonDocument::fromJson(File.readAll()).object() : QJsonObject();
+        if (Manifest.isEmpty()) {
+            (*report)["golden"] = QJsonObject {{"directory", directory}, {"error", "No manifest: the references must be written by --update-golden"}};
+            return false;
+        }
+        if (Manifest != Current) {
+            Golden["warning"]   = "The references were written by another Qt version or with other image plugins";
+            Golden["reference"] = Manifest;
+        }
+    }
+
+    for (int i = 0; i < Depths.count(); i++) {
+        QString SourceName = QString("source-%1.png").arg(SyntheticImages::depthName(Depths.at(i)));
+        QString Source     = Directory.filePath(SourceName);
+        if (update && !QImageWriter(Source, "png").write(SyntheticImages::generate(OrgSize, Depths.at(i), SYNTHETIC_IMAGE_SEED + i))) {
+            Results << QJsonObject {{"name", SourceName}, {"passed", false}, {"error", "Couldn't write the source"}};
+            Failures++;
+            continue;
+        }
+        if (!QFile::exists(Source)) {
+            Results << QJsonObject {{"name", SourceName}, {"passed", false}, {"error", "No source"}};
+            Failures++;
+            continue;
+        }
+
+        for (const ResizeParameters& Method : Methods) {
+            for (Resampler::Filter Filter : Filters) {
+                QString              Name     = QString("%1-%2-%3.png").arg(SyntheticImages::depthName(Depths.at(i)), methodName(Method), Resampler::filterName(Filter));
+                QString              Output   = Temporary.filePath(Name);
+                QSize                Expected = Method.newSize(OrgSize);
+                ResizeOptions        Options;
+                ErrorRecords::Stage  Stage;
+                ErrorRecords::Reason Reason;
+                QString              Error;
+                QJsonObject          Entry;
+                Entry["name"]  = Name;
+                Options.Filter = Filter;
+
+                // The engine overwrites the file it resizes: it works on a copy of the source
+                QFile::remove(Output);
+                bool   Copied  = QFile::copy(Source, Output);
+                bool   Resized = Copied && ResizeEngine(Options).resize(ResizeJob {i, Output, OrgSize, Expected}, &Stage, &Reason);
+                QImage Result  = Resized ? QImage(Output) : QImage();
+
+                if (!Copied) {
+                    Error = "Couldn't copy the source";
+                }
+                else if (!Resized) {
+                    Error = QString("Resizing failed: %1, %2").arg(ErrorRecords::stageName(Stage), ErrorRecords::reasonName(Reason));
+                }
+                else if (Result.size() != Expected) {
+                    Error = QString("Size is %1x%2 instead of %3x%4").arg(Result.width()).arg(Result.height()).arg(Expected.width()).arg(Expected.height());
+                }
+                else if (update) {
+                    QFile::remove(Directory.filePath(Name));
+                    if (!QFile::copy(Output, Directory.filePath(Name))) {
+                        Error = "Couldn't write the reference";
+                    }
+                }
+                else {
+                    QImage Reference(Directory.filePath(Name));
+                    if (Reference.isNull()) {
+                        Error = "No reference";
+                    }
+                    else if (Reference.size() != Result.size()) {
+                        Error = "Size differs from the reference";
+                    }
+                    else {
+                        double Psnr   = psnr(Result, Reference);
+                        double Ssim   = ssim(Result, Reference);
+                        Entry["psnr"] = Psnr;
+                        Entry["ssim"] = Ssim;
+                        if ((Psnr < GOLDEN_MIN_PSNR) || (Ssim < GOLDEN_MIN_SSIM)) {
+                            Error = "Differs from the reference";
+                        }
+                    }
+                }
+
+                Entry["passed"] = Error.isEmpty();
+                if (!Error.isEmpty()) {
+                    Entry["error"] = Error;
+                    Failures++;
+                }
+                Results << Entry;
+            }
+        }
+    }
+
+    // The manifest is written last, so an interrupted update doesn't leave references which look valid
+    if (update && (Failures == 0)) {
+        QFile File(Directory.filePath(GOLDEN_MANIFEST));
+        if (!File.open(QIODevice::WriteOnly | QIODevice::Truncate) || (File.write(QJsonDocument(Current).toJson()) < 0)) {
+            Golden["error"] = "Couldn't write the manifest";
+            Failures++;
+        }
+    }
+
+    Golden["directory"]   = directory;
+    Golden["environment"] = Current;
+    Golden["updated"]     = update;
+    Golden["min_psnr"]    = GOLDEN_MIN_PSNR;
+    Golden["min_ssim"]    = GOLDEN_MIN_SSIM;
+    Golden["failures"]    = Failures;
+    Golden["results"]     = Results;
+    (*report)["golden"] = Golden;
+    return Failures == 0;
+}
+
+//
+//  checkBaseline
+//
+// Compare the throughputs of a report to the ones of a baseline report: probe files/s, resize Mpx/s, and Mpx/s of each
+// stage of each picture. Metrics missing from one of the reports (quick run vs. full run) are not compared.
+// Results of another core count or Qt version are still compared, but the report warns about it
+//
+
+bool RegressionCheck::checkBaseline(const QJsonObject& current, const QJsonObject& baseline, double tolerance, QJsonObject* report)
+{
+    auto throughputs = [](const QJsonObject& report) {
+        QMap<QString, double> Values;
+        Values["probe.files_per_second"]       = report.value("probe").toObject().value("files_per_second").toDouble();
+        Values["resize.megapixels_per_second"] = report.value("resize").toObject().value("megapixels_per_second").toDouble();
+
+        QJsonObject Stages = report.value("stages").toObject();
+        for (auto Picture = Stages.constBegin(); Picture != Stages.constEnd(); ++Picture) {
+            QJsonObject Measures = Picture.value().toObject();
+            for (auto Stage = Measures.constBegin(); Stage != Measures.constEnd(); ++Stage) {
+                Values[QString("stages.%1.%2.megapixels_per_second").arg(Picture.key(), Stage.key())] = Stage.value().toObject().value("megapixels_per_second").toDouble();
+            }
+        }
+        return Values;
+    };
+
+    QMap<QString, double> Current  = throughputs(current);
+    QMap<QString, double> Baseline = throughputs(baseline);
+    QJsonArray            Regressions;
+    int                   Compared = 0;
+    for (auto Metric = Baseline.constBegin(); Metric != Baseline.constEnd(); ++Metric) {
+        if (!Current.contains(Metric.key()) || (Metric.value() <= 0)) {
+            continue;
+        }
+
+        Compared++;
+        double Change = (Current.value(Metric.key()) - Metric.value()) * 100 / Metric.value();
+        if (Change < -tolerance) {
+            Regressions << QJsonObject {{"metric", Metric.key()}, {"baseline", Metric.value()}, {"current", Current.value(Metric.key())}, {"change_percent", Change}};
+        }
+    }
+
+    QJsonObject Check;
+    Check["tolerance_percent"] = tolerance;
+    Check["compared"]          = Compared;
+    Check["regressions"]       = Regressions;
+    if ((current.value("cores") != baseline.value("cores")) || (current.value("qt") != baseline.value("qt"))) {
+        Check["warning"] = "The baseline was measured with another core count or Qt version";
+    }
+    (*report)["baseline"] = Check;
+    return Regressions.isEmpty();
+}
+
+//
+//  psnr
+//
+// Peak signal-to-noise ratio of two pictures of the same size, over the four channels, computed in 16 bits
+//
+
+double RegressionCheck::psnr(const QImage& image1, const QImage& image2)
+{
+    QImage Image1 = image1.convertToFormat(QImage::Format_RGBA64);
+    QImage Image2 = image2.convertToFormat(QImage::Format_RGBA64);
+    double Sum    = 0;
+    for (int y = 0; y < Image1.height(); y++) {
+        const QRgba64* Line1 = reinterpret_cast<const QRgba64*>(Image1.constScanLine(y));
+        const QRgba64* Line2 = reinterpret_cast<const QRgba64*>(Image2.constScanLine(y));
+        for (int x = 0; x < Image1.width(); x++) {
+            double Red   = (Line1[x].red() - Line2[x].red()) / 65535.0;
+            double Green = (Line1[x].green() - Line2[x].green()) / 65535.0;
+            double Blue  = (Line1[x].blue() - Line2[x].blue()) / 65535.0;
+            double Alpha = (Line1[x].alpha() - Line2[x].alpha()) / 65535.0;
+            Sum += Red * Red + Green * Green + Blue * Blue + Alpha * Alpha;
+        }
+    }
+
+    double Samples = 4.0 * Image1.width() * Image1.height();
+    if (Sum == 0) {
+        return GOLDEN_MAX_PSNR;
+    }
+    return qMin(GOLDEN_MAX_PSNR, 10 * std::log10(Samples / Sum));
+}
+
+//
+//  ssim
+//
+// Structural similarity of the luma of two pictures of the same size, averaged over non-overlapping 8x8 blocks.
+// Partial blocks at the right and bottom edges are ignored, unless the picture is smaller than a block
+//
+
+double RegressionCheck::ssim(const QImage& image1, const QImage& image2)
+{
+    const double C1    = 0.01 * 0.01;
+    const double C2    = 0.03 * 0.03;
+    QImage       Luma1 = image1.convertToFormat(QImage::Format_Grayscale16);
+    QImage       Luma2 = image2.convertToFormat(QImage::Format_Grayscale16);
+    int          Block = qMin(8, qMin(Luma1.width(), Luma1.height()));
+    double       Sum   = 0;
+    int          Count = 0;
+
+    for (int by = 0; by + Block <= Luma1.height(); by += Block) {
+        for (int bx = 0; bx + Block <= Luma1.width(); bx += Block) {
+            double Sum1    = 0;
+            double Sum2    = 0;
+            double Square1 = 0;
+            double Square2 = 0;
+            double Product = 0;
+            for (int y = by; y < by + Block; y++) {
+                const quint16* Line1 = reinterpret_cast<const quint16*>(Luma1.constScanLine(y));
+                const quint16* Line2 = reinterpret_cast<const quint16*>(Luma2.constScanLine(y));
+                for (int x = bx; x < bx + Block; x++) {
+                    double Value1 = Line1[x] / 65535.0;
+                    double Value2 = Line2[x] / 65535.0;
+                    Sum1    += Value1;
+                    Sum2    += Value2;
+                    Square1 += Value1 * Value1;
+                    Square2 += Value2 * Value2;
+                    Product += Value1 * Value2;
+                }
+            }
+
+            double Pixels     = double(Block) * Block;
+            double Mean1      = Sum1 / Pixels;
+            double Mean2      = Sum2 / Pixels;
+            double Variance1  = Square1 / Pixels - Mean1 * Mean1;
+            double Variance2  = Square2 / Pixels - Mean2 * Mean2;
+            double Covariance = Product / Pixels - Mean1 * Mean2;
+            Sum += ((2 * Mean1 * Mean2 + C1) * (2 * Covariance + C2)) / ((Mean1 * Mean1 + Mean2 * Mean2 + C1) * (Variance1 + Variance2 + C2));
+            Count++;
+        }
+    }
+    return Count == 0 ? 1.0 : Sum / Count;
+}
+
+//
+//  environment
+//
+// Description of the Qt build resizing the pictures: its version, and the image formats its plugins read and write.
+// The references of the golden check depend on it, as the codecs are part of the checked path
+//
+
+QJsonObject RegressionCheck::environment()
+{
+    QJsonArray Readable;
+    QJsonArray Writable;
+    for (const QByteArray& Format : QImageReader::supportedImageFormats()) {
+        Readable << QString(Format);
+    }
+    for (const QByteArray& Format : QImageWriter::supportedImageFormats()) {
+        Writable << QString(Format);
+    }
+    return QJsonObject {{"qt", QString(qVersion())}, {"read_formats", Readable}, {"write_formats", Writable}};
+}
+
+//
+//  methodName
+//
+// Name of a resizing method and its value, used in reference file names: pct50, px256...
+//
+
+QString RegressionCheck::methodName(const ResizeParameters& parameters)
+{
+    if (parameters.Method == ResizeParameters::MethodPercentage) {
+        return QString("pct%1").arg(parameters.Percentage);
+    }
+    return QString("px%1").arg(parameters.AbsoluteSize);
+}
@@ -0,0 +1,83 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef REGRESSIONCHECK_HPP
+#define REGRESSIONCHECK_HPP
+
+#include "../Core/Resampler.hpp"
+#include "../Core/ResizeParameters.hpp"
+#include <QImage>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+//
+//  RegressionCheck
+//
+// This class guards the engine against regressions:
+//   - golden check: pictures of each depth are resized by the engine with each resizing method and filter, and compared
+//     to reference outputs stored in a directory with the sources and the description of the Qt build which wrote them.
+//     A result passes if it has the expected size, and if its PSNR and SSIM against the reference are above the thresholds,
+//     so harmless rounding changes don't fail the check
+//   - baseline check: the throughputs of a benchmark report are compared to a report previously written on the same machine.
+//     A throughput lower than the baseline by more than the tolerance is a regression
+//
+
+class RegressionCheck
+{
+  public:
+    static bool   checkGolden(const QString& directory, bool update, QJsonObject* report);                                 // Compare the resized pictures to the references, or write them if update is true. Return false on failure
+    static bool   checkBaseline(const QJsonObject& current, const QJsonObject& baseline, double tolerance, QJsonObject* report); // Compare the throughputs of two reports. Return false if one regressed
+    static double psnr(const QImage& image1, const QImage& image2);                                                         // Peak signal-to-noise ratio over all channels, in dB
+    static double ssim(const QImage& image1, const QImage& image2);                                                         // Structural similarity of the luma, on 8x8 blocks
+
+  private:
+    static QJsonObject environment();                                  // Qt version and image plugins, recorded with the references
+    static QString     methodName(const ResizeParameters& parameters); // Name of a resizing method, used in reference file names
+};
+
+//
+//  Thresholds of the golden check. Identical pictures have an infinite PSNR, reported as GOLDEN_MAX_PSNR
+//
+
+#define GOLDEN_MIN_PSNR 45.0
+#define GOLDEN_MIN_SSIM 0.995
+#define GOLDEN_MAX_PSNR 100.0
+
+//
+//  Size of the source pictures of the golden check. Small, as the references are stored in the repository
+//
+
+#define GOLDEN_IMAGE_WIDTH 128
+#define GOLDEN_IMAGE_HEIGHT 96
+
+//
+//  File of the golden directory describing the Qt build which wrote the references
+//
+
+#define GOLDEN_MANIFEST "manifest.json"
+
+//
+//  Default tolerance of the baseline check, in percent
+//
+
+#define BASELINE_DEFAULT_TOLERANCE 15
+
+#endif // REGRESSIONCHECK_HPP
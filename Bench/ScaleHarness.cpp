@@ -0,0 +1,409 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "ScaleHarness.hpp"
+#include "../Core/DropThread.hpp"
+#include "../Core/FileStore.hpp"
+#include "../Core/FileWalker.hpp"
+#include "../Core/ImageLimits.hpp"
+#include "../Core/ResizeJob.hpp"
+#include "../Core/ResizeOptions.hpp"
+#include "../Core/ResizeThread.hpp"
+#include "../UI/TableModel.hpp"
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QObject>
+#include <QPair>
+#include <QSize>
+#include <QStringList>
+#include <QTableView>
+#include <QUrl>
+#include <algorithm>
+#include <cmath>
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+namespace {
+    //
+    //  percentile
+    //
+    // Nearest rank percentile of sorted values given in ns, returned in ms
+    //
+
+    double percentile(const QVector<qint64>& sorted, int percent)
+    {
+        if (sorted.isEmpty()) {
+            return 0.0;
+        }
+        int Index = qBound(0, int(std::ceil(percent * sorted.count() / 100.0)) - 1, sorted.count() - 1);
+        return sorted.at(Index) / 1e6;
+    }
+} // namespace
+
+//
+//  LagMonitor
+//
+// Constructor
+//
+
+LagMonitor::LagMonitor()
+    : Last(0)
+{
+    this->Timer.setInterval(SCALE_LAG_INTERVAL);
+    this->Timer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&this->Timer, &QTimer::timeout, [this]() {
+        qint64 Now = this->Clock.nsecsElapsed();
+        this->Lags << qMax(qint64(0), Now - this->Last - SCALE_LAG_INTERVAL * 1000000LL);
+        this->Last = Now;
+    });
+}
+
+//
+//  start
+//
+// Start sampling. The ticks are only handled while the event loop runs
+//
+
+void LagMonitor::start()
+{
+    this->Lags.clear();
+    this->Clock.start();
+    this->Last = 0;
+    this->Timer.start();
+}
+
+//
+//  stop
+//
+// Stop sampling
+//
+
+void LagMonitor::stop()
+{
+    this->Timer.stop();
+}
+
+//
+//  elapsed
+//
+// Time since start(), in ns. The harness uses it as its clock
+//
+
+qint64 LagMonitor::elapsed() const
+{
+    return this->Clock.nsecsElapsed();
+}
+
+//
+//  statistics
+//
+// Percentiles of the lags, in ms
+//
+
+QJsonObject LagMonitor::statistics() const
+{
+    QVector<qint64> Sorted = this->Lags;
+    std::sort(Sorted.begin(), Sorted.end());
+    return QJsonObject {{"samples", Sorted.count()}, {"p50", percentile(Sorted, 50)}, {"p99", percentile(Sorted, 99)}, {"max", percentile(Sorted, 100)}};
+}
+
+//
+//  ScaleHarness
+//
+// Constructor
+//
+
+ScaleHarness::ScaleHarness(const QString& directory, const TreeSpec& spec, bool resize)
+    : Directory(directory)
+    , Spec(spec)
+    , Resize(resize)
+{
+}
+
+//
+//  run
+//
+// Measure each file count, smallest first, then compute the growth exponents
+//
+
+bool ScaleHarness::run(const QList<int>& counts, QJsonObject* report, QString* error)
+{
+    QList<int> Counts = counts;
+    std::sort(Counts.begin(), Counts.end());
+
+    QJsonArray Points;
+    for (int Files : Counts) {
+        QJsonObject Point;
+        if (!measure(Files, &Point, error)) {
+            return false;
+        }
+        Points << Point;
+    }
+
+    QJsonArray Scaling     = scaling(Points);
+    bool       Superlinear = false;
+    for (const QJsonValue& Step : Scaling) {
+        Superlinear |= Step.toObject().value("superlinear").toBool();
+    }
+
+    (*report)["tree"]        = QJsonObject {{"depth", this->Spec.Depth}, {"fanout", this->Spec.Fanout}, {"image_side", this->Spec.ImageSide}, {"non_images_percent", this->Spec.NonImages}};
+    (*report)["points"]      = Points;
+    (*report)["scaling"]     = Scaling;
+    (*report)["superlinear"] = Superlinear;
+    return true;
+}
+
+//
+//  measure
+//
+// Generate a tree of the given size, measure it, then remove it. The threads are released after each measure,
+// so each file count starts from the same state
+//
+
+bool ScaleHarness::measure(int files, QJsonObject* point, QString* error)
+{
+    TreeSpec Spec = this->Spec;
+    Spec.Files    = files;
+    QString Root  = QDir(this->Directory).filePath(QString("tree-%1").arg(files));
+    QDir(Root).removeRecursively();
+
+    QElapsedTimer Timer;
+    Timer.start();
+    if (!TreeGenerator::generate(Root, Spec, error)) {
+        QDir(Root).removeRecursively();
+        return false;
+    }
+    (*point)["files"]       = files;
+    (*point)["generate_ms"] = Timer.nsecsElapsed() / 1e6;
+
+    TableModel  Model;
+    QJsonObject Drop = measureDrop(Root, &Model);
+    (*point)["drop"] = Drop;
+    if (this->Resize) {
+        (*point)["resize"] = measureResize(&Model);
+    }
+
+    Model.clear();
+    DropThread::release();
+    ResizeThread::release();
+    QDir(Root).removeRecursively();
+    return true;
+}
+
+//
+//  measureDrop
+//
+// Scan and drop a tree, as the main window does when a directory is dropped on it: the walk runs in the event loop thread,
+// the probes in the drop thread, and the results are appended to the model through queued signals.
+// The time to table stops when the last result is displayed. The memory per row is the growth of the resident memory
+// divided by the number of rows, so it includes the drop thread results and the view
+//
+
+QJsonObject ScaleHarness::measureDrop(const QString& root, TableModel* model)
+{
+    DropThread* Prober   = DropThread::instance();
+    QObject     Context;
+    QEventLoop  Loop;
+    LagMonitor  Lag;
+    QTableView  View;
+    int         Rejected = 0;
+    qint64      FirstRow = -1;
+
+    View.setModel(model);
+    View.resize(1280, 800);
+    View.show();
+
+    QObject::connect(Prober, &DropThread::dropResultReady, &Context, [&]() {
+        QList<QPair<QString, QSize>> Result;
+        QStringList                  Oversized;
+        Prober->result(&Result, &Oversized);
+        Rejected += Oversized.count();
+
+        QList<QPair<QString, QSize>> ValidFiles;
+        ValidFiles.reserve(Result.size());
+        for (int i = 0; i < Result.size(); i++) {
+            if (Result.at(i).second.isValid()) {
+                ValidFiles << Result.at(i);
+            }
+            else {
+                Rejected++;
+            }
+        }
+        model->append(ValidFiles);
+    }, Qt::QueuedConnection);
+    QObject::connect(Prober, &DropThread::dropProcessTerminaded, &Context, [&]() { Loop.quit(); }, Qt::QueuedConnection);
+    QObject::connect(model, &TableModel::rowsInserted, &Context, [&]() {
+        if (FirstRow < 0) {
+            FirstRow = Lag.elapsed();
+        }
+    });
+
+    qint64 RssBefore = currentRss();
+    Lag.start();
+
+    QStringList Files;
+    FileWalker::getFiles(Files, root, false);
+    qint64 Scan = Lag.elapsed();
+
+    QList<QUrl> Urls;
+    Urls.reserve(Files.count());
+    for (const QString& File : Files) {
+        Urls << QUrl::fromLocalFile(File);
+    }
+    Files.clear();
+
+    Prober->setLimits(ImageLimits::fromSettings());
+    Prober->drop(Urls);
+    Loop.exec();
+    qint64 Elapsed = Lag.elapsed();
+    Lag.stop();
+
+    qint64 RssAfter = currentRss();
+    int    Rows     = model->rowCount();
+
+    QJsonObject Drop;
+    Drop["rows"]                = Rows;
+    Drop["rejected"]            = Rejected;
+    Drop["scan_ms"]             = Scan / 1e6;
+    Drop["first_row_ms"]        = FirstRow / 1e6;
+    Drop["time_to_table_ms"]    = Elapsed / 1e6;
+    Drop["rss_delta_kb"]        = RssAfter - RssBefore;
+    Drop["rss_bytes_per_entry"] = Rows > 0 ? (RssAfter - RssBefore) * 1024.0 / Rows : 0.0;
+    Drop["lag_ms"]              = Lag.statistics();
+    return Drop;
+}
+
+//
+//  measureResize
+//
+// Resize all the files of the model with the default engine settings. Results go back to the model through queued signals,
+// as in the main window, so the lag includes the updates of the table
+//
+
+QJsonObject ScaleHarness::measureResize(TableModel* model)
+{
+    ResizeThread*    Resizer  = ResizeThread::instance();
+    QList<ResizeJob> Jobs     = model->queueJobs();
+    QObject          Context;
+    QEventLoop       Loop;
+    LagMonitor       Lag;
+    int              Resized  = 0;
+    int              Failures = 0;
+    qint64           Pixels   = 0;
+
+    for (const ResizeJob& Job : Jobs) {
+        Pixels += qint64(Job.OrgSize.width()) * Job.OrgSize.height();
+    }
+
+    QObject::connect(Resizer, &ResizeThread::fileResized, &Context, [&](int id, bool success) {
+        model->setJobStatus(id, success ? FileStore::StatusDone : FileStore::StatusFailed);
+        Resized++;
+        Failures += success ? 0 : 1;
+    }, Qt::QueuedConnection);
+    QObject::connect(Resizer, &ResizeThread::resizingTerminated, &Context, [&]() { Loop.quit(); }, Qt::QueuedConnection);
+    QObject::connect(Resizer, &ResizeThread::resizingAborted, &Context, [&]() { Loop.quit(); }, Qt::QueuedConnection);
+
+    Lag.start();
+    Resizer->resize(Jobs, ResizeOptions());
+    Loop.exec();
+    model->flushJobs();
+    double Seconds = Lag.elapsed() / 1e9;
+    Lag.stop();
+
+    QJsonObject Resize;
+    Resize["files"]                 = Resized;
+    Resize["failures"]              = Failures;
+    Resize["elapsed_ms"]            = Seconds * 1e3;
+    Resize["files_per_second"]      = Seconds > 0 ? Resized / Seconds : 0.0;
+    Resize["megapixels_per_second"] = Seconds > 0 ? Pixels / 1e6 / Seconds : 0.0;
+    Resize["lag_ms"]                = Lag.statistics();
+    return Resize;
+}
+
+//
+//  scaling
+//
+// Growth exponent of each measure between two successive file counts: log(m2 / m1) / log(n2 / n1).
+// 1 is linear. Measures too small to be meaningful (below 1 ms or 1 MB) are skipped
+//
+
+QJsonArray ScaleHarness::scaling(const QJsonArray& points)
+{
+    struct Measure
+    {
+        const char* Section; // Object of the point holding the measure
+        const char* Name;    // Name of the measure
+        double      Minimum; // Smallest value considered meaningful
+    };
+    const Measure Measures[] = {
+        {"drop", "scan_ms", 1.0},
+        {"drop", "time_to_table_ms", 1.0},
+        {"drop", "rss_delta_kb", 1024.0},
+        {"resize", "elapsed_ms", 1.0},
+    };
+
+    QJsonArray Steps;
+    for (int i = 1; i < points.count(); i++) {
+        QJsonObject Previous    = points.at(i - 1).toObject();
+        QJsonObject Current     = points.at(i).toObject();
+        double      Ratio       = Current.value("files").toDouble() / Previous.value("files").toDouble();
+        QJsonObject Exponents;
+        bool        Superlinear = false;
+        if (Ratio <= 1.0) {
+            continue;
+        }
+
+        for (const Measure& Measured : Measures) {
+            double From = Previous.value(Measured.Section).toObject().value(Measured.Name).toDouble();
+            double To   = Current.value(Measured.Section).toObject().value(Measured.Name).toDouble();
+            if ((From < Measured.Minimum) || (To < Measured.Minimum)) {
+                continue;
+            }
+            double Exponent = std::log(To / From) / std::log(Ratio);
+            Exponents[QString("%1.%2").arg(Measured.Section, Measured.Name)] = Exponent;
+            Superlinear |= Exponent > SCALE_SUPERLINEAR_EXPONENT;
+        }
+
+        Steps << QJsonObject {{"from", Previous.value("files")}, {"to", Current.value("files")}, {"exponents", Exponents}, {"superlinear", Superlinear}};
+    }
+    return Steps;
+}
+
+//
+//  currentRss
+//
+// Resident memory of the process, in kB. Read from /proc on Linux, 0 elsewhere
+//
+
+qint64 ScaleHarness::currentRss()
+{
+#ifdef Q_OS_UNIX
+    QFile Statm("/proc/self/statm");
+    if (!Statm.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    QList<QByteArray> Fields = Statm.readAll().split(' ');
+    return Fields.count() > 1 ? Fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE) / 1024 : 0;
+#else
+    return 0;
+#endif
+}
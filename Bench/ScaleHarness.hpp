@@ -0,0 +1,105 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef SCALEHARNESS_HPP
+#define SCALEHARNESS_HPP
+
+#include "TreeGenerator.hpp"
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+class TableModel;
+
+//
+//  LagMonitor
+//
+// This class measures the responsiveness of the event loop: a precise timer is armed at a short interval,
+// the lag of a tick is the time elapsed beyond that interval. A blocked event loop gives one large lag
+//
+
+class LagMonitor
+{
+  public:
+    LagMonitor();
+    void        start();            // Start sampling
+    void        stop();             // Stop sampling
+    qint64      elapsed() const;    // Time since start(), in ns
+    QJsonObject statistics() const; // Percentiles of the lags, in ms
+
+  private:
+    QTimer          Timer; // Ticking timer
+    QElapsedTimer   Clock; // Timestamps the ticks
+    qint64          Last;  // Time of the previous tick, in ns
+    QVector<qint64> Lags;  // Lag of each tick, in ns
+};
+
+//
+//  ScaleHarness
+//
+// This class measures how the drop path scales with the number of files. For each file count, a tree is generated, then:
+//   - scan:   the directory walk done by the main window when a directory is dropped
+//   - drop:   the time until all the files are displayed in the table, with the event loop lag and the memory per row
+//   - resize: the throughput of a resizing process of all the files, with the event loop lag
+// The table is a real view on the real model, shown on the offscreen platform, so its costs are included.
+// Between two file counts, the exponent of the growth of each measure is computed: above 1, the cost grows faster than the file count
+//
+
+class ScaleHarness
+{
+  public:
+    ScaleHarness(const QString& directory, const TreeSpec& spec, bool resize);
+    bool run(const QList<int>& counts, QJsonObject* report, QString* error); // Measure each file count. Return false if a tree couldn't be generated
+
+  private:
+    bool              measure(int files, QJsonObject* point, QString* error); // Generate a tree of the given size and measure it
+    QJsonObject       measureDrop(const QString& root, TableModel* model);    // Scan and drop a tree into the model, until all rows are displayed
+    QJsonObject       measureResize(TableModel* model);                       // Resize all the files of the model
+    static QJsonArray scaling(const QJsonArray& points);                      // Growth exponents between successive file counts
+    static qint64     currentRss();                                           // Resident memory of the process, in kB. 0 if unknown
+
+    QString  Directory; // Directory holding the generated trees
+    TreeSpec Spec;      // Shape of the trees. The file count is overridden by each measure
+    bool     Resize;    // Measure the resizing process too
+};
+
+//
+//  Default file counts measured
+//
+
+#define SCALE_DEFAULT_COUNTS "1000,10000,100000"
+
+//
+//  Interval of the event loop lag timer, in ms
+//
+
+#define SCALE_LAG_INTERVAL 5
+
+//
+//  Growth exponent above which a measure is reported as superlinear
+//
+
+#define SCALE_SUPERLINEAR_EXPONENT 1.2
+
+#endif // SCALEHARNESS_HPP
@@ -0,0 +1,129 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "Benchmark.hpp"
+#include "ScaleHarness.hpp"
+#include "TreeGenerator.hpp"
+#include <QApplication>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+//
+//  main
+//
+// Entry point of picres_scale. Generate a tree for each file count in a temporary directory (or in the given one),
+// measure the drop path and the resizing process on it, and write the JSON report on the standard output or in a file.
+// The offscreen platform is used unless another one is requested, so the harness runs without display.
+// The exit code tells if a measure grew faster than the file count
+//
+
+int main(int argc, char* argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication::setOrganizationName("Folco");
+    QApplication::setApplicationName("PicResBench");
+    QApplication Application(argc, argv);
+    QTextStream  Err(stderr);
+
+    QCommandLineParser Parser;
+    QCommandLineOption Output(QStringList {"o", "output"}, "Write the JSON report to a file instead of the standard output.", "file");
+    QCommandLineOption Counts("counts", QString("Comma-separated file counts to measure (%1 by default).").arg(SCALE_DEFAULT_COUNTS), "counts");
+    QCommandLineOption Depth("depth", "Number of directory levels of the trees (3 by default).", "levels");
+    QCommandLineOption Fanout("fanout", "Number of subdirectories of each directory (10 by default).", "count");
+    QCommandLineOption ImageSide("image-size", "Side of the generated pictures, in pixels (64 by default).", "pixels");
+    QCommandLineOption NonImages("non-images", "Percentage of files which are not pictures (5 by default).", "percent");
+    QCommandLineOption Directory("directory", "Generate the trees in this directory. A temporary directory is used by default.", "directory");
+    QCommandLineOption NoResize("no-resize", "Only measure the drop path.");
+    Parser.setApplicationDescription("Scalability harness of the PicRes drop path on generated directory trees.");
+    Parser.addHelpOption();
+    Parser.addOption(Output);
+    Parser.addOption(Counts);
+    Parser.addOption(Depth);
+    Parser.addOption(Fanout);
+    Parser.addOption(ImageSide);
+    Parser.addOption(NonImages);
+    Parser.addOption(Directory);
+    Parser.addOption(NoResize);
+    Parser.process(Application);
+
+    // Read an integer option, within bounds
+    bool Valid = true;
+    auto value = [&](const QCommandLineOption& option, int defaultvalue, int minimum, int maximum) {
+        bool Ok    = true;
+        int  Value = Parser.isSet(option) ? Parser.value(option).toInt(&Ok) : defaultvalue;
+        Valid &= Ok && (Value >= minimum) && (Value <= maximum);
+        return Value;
+    };
+
+    TreeSpec Spec;
+    Spec.Files     = 0;
+    Spec.Depth     = value(Depth, 3, 0, 16);
+    Spec.Fanout    = value(Fanout, 10, 1, 1000);
+    Spec.ImageSide = value(ImageSide, 64, 1, 4096);
+    Spec.NonImages = value(NonImages, 5, 0, 100);
+
+    QList<int> Files;
+    for (const QString& Count : (Parser.isSet(Counts) ? Parser.value(Counts) : QString(SCALE_DEFAULT_COUNTS)).split(',')) {
+        bool Ok    = true;
+        int  Value = Count.trimmed().toInt(&Ok);
+        Valid &= Ok && (Value > 0);
+        Files << Value;
+    }
+    if (!Valid) {
+        Err << "Invalid option value.\n\n" << Parser.helpText();
+        return BENCH_EXIT_USAGE;
+    }
+
+    QTemporaryDir Temporary;
+    QString       Path = Parser.isSet(Directory) ? Parser.value(Directory) : Temporary.path();
+    if (!QDir().mkpath(Path)) {
+        Err << QString("Couldn't create %1\n").arg(Path);
+        return BENCH_EXIT_FAILURE;
+    }
+
+    QJsonObject Report;
+    QString     Error;
+    if (!ScaleHarness(Path, Spec, !Parser.isSet(NoResize)).run(Files, &Report, &Error)) {
+        Err << Error << "\n";
+        return BENCH_EXIT_FAILURE;
+    }
+    int ExitCode = Report.value("superlinear").toBool() ? BENCH_EXIT_FAILURE : BENCH_EXIT_SUCCESS;
+
+    QByteArray Json = QJsonDocument(Report).toJson();
+    if (!Parser.isSet(Output)) {
+        QTextStream(stdout) << Json;
+        return ExitCode;
+    }
+
+    QFile File(Parser.value(Output));
+    if (!File.open(QIODevice::WriteOnly | QIODevice::Truncate) || (File.write(Json) != Json.size())) {
+        Err << QString("Couldn't write %1\n").arg(File.fileName());
+        return BENCH_EXIT_FAILURE;
+    }
+    return ExitCode;
+}
@@ -0,0 +1,140 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "SyntheticImages.hpp"
+#include <QRandomGenerator>
+#include <QRgba64>
+
+//
+//  name
+//
+// File name of a picture, made of its dimensions, depth and format. Names are stable, so reports of different runs can be compared
+//
+
+QString SyntheticImage::name() const
+{
+    return QString("%1x%2-%3.%4").arg(this->Size.width()).arg(this->Size.height()).arg(SyntheticImages::depthName(this->Depth), QString(this->Format));
+}
+
+//
+//  catalog
+//
+// Pictures to benchmark: the usual sizes (VGA, full HD, 12 Mpx camera), in the formats and depths the engine handles natively.
+// The full run adds a 48 Mpx JPEG, typical of recent cameras. Formats without a writer (TIFF without its plugin) are skipped by the caller
+//
+
+QList<SyntheticImage> SyntheticImages::catalog(bool quick)
+{
+    QList<QSize> Sizes {QSize(640, 480), QSize(1920, 1080)};
+    if (!quick) {
+        Sizes << QSize(4000, 3000);
+    }
+
+    QList<SyntheticImage> Catalog;
+    for (const QSize& Size : Sizes) {
+        Catalog << SyntheticImage {Size, QImage::Format_RGB888, "jpg"};
+        Catalog << SyntheticImage {Size, QImage::Format_Grayscale8, "jpg"};
+        Catalog << SyntheticImage {Size, QImage::Format_RGB888, "png"};
+        Catalog << SyntheticImage {Size, QImage::Format_Grayscale8, "png"};
+        Catalog << SyntheticImage {Size, QImage::Format_ARGB32, "png"};
+        Catalog << SyntheticImage {Size, QImage::Format_RGBA64, "png"};
+        Catalog << SyntheticImage {Size, QImage::Format_RGB888, "bmp"};
+        Catalog << SyntheticImage {Size, QImage::Format_RGB888, "tif"};
+    }
+    if (!quick) {
+        Catalog << SyntheticImage {QSize(8000, 6000), QImage::Format_RGB888, "jpg"};
+    }
+    return Catalog;
+}
+
+//
+//  generate
+//
+// Return a deterministic picture. Channels are 16-bit gradients (horizontal, vertical, diagonal),
+// with a checkerboard giving hard edges and random noise in the low bits, so encoders can't compress it to nothing.
+// Alpha is a vertical gradient. Pixels are written directly in the requested format, without a full-size intermediate picture
+//
+
+QImage SyntheticImages::generate(QSize size, QImage::Format depth, quint32 seed)
+{
+    if ((depth != QImage::Format_Grayscale8) && (depth != QImage::Format_RGB888) && (depth != QImage::Format_ARGB32) && (depth != QImage::Format_RGBA64)) {
+        return QImage();
+    }
+
+    QImage Image(size, depth);
+    if (Image.isNull()) {
+        return Image;
+    }
+
+    QRandomGenerator Generator(seed);
+    int              Width  = size.width();
+    int              Height = size.height();
+    for (int y = 0; y < Height; y++) {
+        uchar* Line = Image.scanLine(y);
+        for (int x = 0; x < Width; x++) {
+            quint32 Noise = Generator.generate();
+            quint16 Edge  = (((x / 64) + (y / 64)) & 1) ? 0x2000 : 0;
+            quint16 Red   = quint16((qint64(x) * 0xDFFF / qMax(Width - 1, 1)) + Edge) ^ quint16(Noise & 0x0FFF);
+            quint16 Green = quint16((qint64(y) * 0xDFFF / qMax(Height - 1, 1)) + Edge) ^ quint16((Noise >> 12) & 0x0FFF);
+            quint16 Blue  = quint16((qint64(x + y) * 0xDFFF / qMax(Width + Height - 2, 1)) + Edge) ^ quint16((Noise >> 20) & 0x0FFF);
+            quint16 Alpha = quint16(0x4000 + qint64(y) * 0xBFFF / qMax(Height - 1, 1));
+
+            switch (depth) {
+                case QImage::Format_Grayscale8:
+                    Line[x] = uchar(((Red + Green + Blue) / 3) >> 8);
+                    break;
+                case QImage::Format_RGB888:
+                    Line[3 * x]     = uchar(Red >> 8);
+                    Line[3 * x + 1] = uchar(Green >> 8);
+                    Line[3 * x + 2] = uchar(Blue >> 8);
+                    break;
+                case QImage::Format_ARGB32:
+                    reinterpret_cast<QRgb*>(Line)[x] = qRgba(Red >> 8, Green >> 8, Blue >> 8, Alpha >> 8);
+                    break;
+                default: // Format_RGBA64
+                    reinterpret_cast<QRgba64*>(Line)[x] = QRgba64::fromRgba64(Red, Green, Blue, Alpha);
+                    break;
+            }
+        }
+    }
+    return Image;
+}
+
+//
+//  depthName
+//
+// Name of a pixel format, used in file names and reports
+//
+
+QString SyntheticImages::depthName(QImage::Format depth)
+{
+    switch (depth) {
+        case QImage::Format_Grayscale8:
+            return "gray8";
+        case QImage::Format_RGB888:
+            return "rgb888";
+        case QImage::Format_ARGB32:
+            return "argb32";
+        case QImage::Format_RGBA64:
+            return "rgba64";
+        default:
+            return QString("format%1").arg(int(depth));
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef SYNTHETICIMAGES_HPP
+#define SYNTHETICIMAGES_HPP
+
+#include <QByteArray>
+#include <QImage>
+#include <QList>
+#include <QSize>
+#include <QString>
+
+//
+//  SyntheticImage
+//
+// Description of a generated benchmark picture: dimensions, pixel format (bit depth) and file format
+//
+
+struct SyntheticImage
+{
+    QSize          Size;   // Dimensions of the picture
+    QImage::Format Depth;  // Pixel format of the generated picture, written as is when the file format supports it
+    QByteArray     Format; // File format, also used as file extension
+
+    QString name() const; // File name, made of the dimensions, the depth and the format
+};
+
+//
+//  SyntheticImages
+//
+// This class generates the pictures of the benchmark. They are deterministic: a given seed always gives the same pixels,
+// so results of different runs and different machines can be compared. Pictures are gradients with noise and hard edges,
+// which compress like photographs rather than like flat areas
+//
+
+class SyntheticImages
+{
+  public:
+    static QList<SyntheticImage> catalog(bool quick);                                      // Pictures to benchmark. Quick mode skips the largest ones
+    static QImage                generate(QSize size, QImage::Format depth, quint32 seed); // Return a deterministic picture, null if the format is not supported
+    static QString               depthName(QImage::Format depth);                          // Name of a pixel format, used in file names and reports
+};
+
+//
+//  Seed of the generated pictures. Changing it invalidates the results of previous runs
+//
+
+#define SYNTHETIC_IMAGE_SEED 0x50696352
+
+#endif // SYNTHETICIMAGES_HPP
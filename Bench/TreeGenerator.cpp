@@ -0,0 +1,101 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "TreeGenerator.hpp"
+#include "SyntheticImages.hpp"
+#include <QBuffer>
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QImageWriter>
+#include <QStringList>
+
+//
+//  generate
+//
+// Write the tree. The file i goes to the leaf i % leaves, so all the leaves get the same number of files.
+// Every hundred files, NonImages of them are text files, the other ones alternate between JPEG and PNG
+//
+
+bool TreeGenerator::generate(const QString& root, const TreeSpec& spec, QString* error)
+{
+    // Encode the contents once
+    QImage     Image = SyntheticImages::generate(QSize(spec.ImageSide, spec.ImageSide), QImage::Format_RGB888, SYNTHETIC_IMAGE_SEED);
+    QByteArray Jpeg;
+    QByteArray Png;
+    QByteArray Text("Not a picture\n");
+    {
+        QBuffer Buffer(&Jpeg);
+        Buffer.open(QIODevice::WriteOnly);
+        QImageWriter(&Buffer, "jpg").write(Image);
+    }
+    {
+        QBuffer Buffer(&Png);
+        Buffer.open(QIODevice::WriteOnly);
+        QImageWriter(&Buffer, "png").write(Image);
+    }
+    if (Jpeg.isEmpty() || Png.isEmpty()) {
+        *error = "Couldn't encode the pictures";
+        return false;
+    }
+
+    // Leaf paths: the digits of the leaf index in base fanout
+    int         Leaves = leafCount(spec);
+    QStringList LeafPaths;
+    LeafPaths.reserve(Leaves);
+    for (int Leaf = 0; Leaf < Leaves; Leaf++) {
+        QString Path = root;
+        for (int Level = 0, Index = Leaf; Level < spec.Depth; Level++, Index /= spec.Fanout) {
+            Path += QString("/d%1").arg(Index % spec.Fanout);
+        }
+        if (!QDir().mkpath(Path)) {
+            *error = QString("Couldn't create %1").arg(Path);
+            return false;
+        }
+        LeafPaths << Path + "/";
+    }
+
+    for (int i = 0; i < spec.Files; i++) {
+        bool              IsImage  = (i % 100) >= spec.NonImages;
+        const QByteArray& Content  = !IsImage ? Text : (i % 2 == 0 ? Jpeg : Png);
+        QString           Filename = LeafPaths.at(i % Leaves) + QString("f%1.%2").arg(i).arg(!IsImage ? "txt" : (i % 2 == 0 ? "jpg" : "png"));
+        QFile             File(Filename);
+        if (!File.open(QIODevice::WriteOnly) || (File.write(Content) != Content.size())) {
+            *error = QString("Couldn't write %1").arg(Filename);
+            return false;
+        }
+    }
+    return true;
+}
+
+//
+//  leafCount
+//
+// Number of leaf directories: fanout ^ depth, bounded so a deep tree doesn't create more directories than files
+//
+
+int TreeGenerator::leafCount(const TreeSpec& spec)
+{
+    qint64 Leaves = 1;
+    for (int Level = 0; (Level < spec.Depth) && (Leaves < spec.Files); Level++) {
+        Leaves *= qMax(spec.Fanout, 1);
+    }
+    return int(qBound(qint64(1), Leaves, qint64(qMax(spec.Files, 1))));
+}
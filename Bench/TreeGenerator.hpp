@@ -0,0 +1,55 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef TREEGENERATOR_HPP
+#define TREEGENERATOR_HPP
+
+#include <QString>
+
+//
+//  TreeSpec
+//
+// Shape of a generated directory tree. Files are spread over the leaf directories
+//
+
+struct TreeSpec
+{
+    int Files;     // Number of files
+    int Depth;     // Number of directory levels below the root
+    int Fanout;    // Number of subdirectories of each directory
+    int ImageSide; // Side of the generated pictures, in pixels
+    int NonImages; // Percentage of files which are not pictures
+};
+
+//
+//  TreeGenerator
+//
+// This class writes a deterministic directory tree, like a photo library: pictures (JPEG and PNG) mixed with other files.
+// Each kind of file is encoded once, then copied, so a million files are written in a few minutes
+//
+
+class TreeGenerator
+{
+  public:
+    static bool generate(const QString& root, const TreeSpec& spec, QString* error); // Write the tree. Return false and an explanation on failure
+    static int  leafCount(const TreeSpec& spec);                                      // Number of leaf directories
+};
+
+#endif // TREEGENERATOR_HPP
@@ -0,0 +1,132 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "Benchmark.hpp"
+#include "RegressionCheck.hpp"
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+//
+//  main
+//
+// Entry point of picres_bench. Generate the pictures in a temporary directory (or in the given one),
+// run the measurements and write the JSON report on the standard output or in a file.
+// With --golden, only check the resampled pictures against the references (or write them with --update-golden).
+// With --baseline, compare the throughputs to a previous report: the exit code tells if the engine regressed.
+// Settings are read and written under their own application name, so the user's PicRes settings are left untouched
+//
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication::setOrganizationName("Folco");
+    QCoreApplication::setApplicationName("PicResBench");
+    QCoreApplication Application(argc, argv);
+    QTextStream      Err(stderr);
+
+    QCommandLineParser Parser;
+    QCommandLineOption Output(QStringList {"o", "output"}, "Write the JSON report to a file instead of the standard output.", "file");
+    QCommandLineOption Iterations(QStringList {"i", "iterations"}, QString("Number of times each measurement is repeated (%1 by default).").arg(BENCH_DEFAULT_ITERATIONS), "count");
+    QCommandLineOption Quick("quick", "Skip the largest pictures.");
+    QCommandLineOption Directory("directory", "Generate the pictures in this directory, and keep them. A temporary directory is used by default.", "directory");
+    QCommandLineOption Golden("golden", "Compare the resized pictures to the references of a directory, instead of running the benchmark.", "directory");
+    QCommandLineOption UpdateGolden("update-golden", "With --golden, write the references instead of comparing to them.");
+    QCommandLineOption Baseline("baseline", "Compare the throughputs to a report previously written on the same machine.", "file");
+    QCommandLineOption Tolerance("tolerance", QString("Throughput loss tolerated by --baseline, in percent (%1 by default).").arg(BASELINE_DEFAULT_TOLERANCE), "percent");
+    Parser.setApplicationDescription("Benchmark of the PicRes engine on generated pictures.");
+    Parser.addHelpOption();
+    Parser.addOption(Output);
+    Parser.addOption(Iterations);
+    Parser.addOption(Quick);
+    Parser.addOption(Directory);
+    Parser.addOption(Golden);
+    Parser.addOption(UpdateGolden);
+    Parser.addOption(Baseline);
+    Parser.addOption(Tolerance);
+    Parser.process(Application);
+
+    bool Valid = true;
+    int  Count = Parser.isSet(Iterations) ? Parser.value(Iterations).toInt(&Valid) : BENCH_DEFAULT_ITERATIONS;
+    if (!Valid || (Count < 1)) {
+        Err << "Invalid iteration count.\n\n" << Parser.helpText();
+        return BENCH_EXIT_USAGE;
+    }
+    double Percent = Parser.isSet(Tolerance) ? Parser.value(Tolerance).toDouble(&Valid) : BASELINE_DEFAULT_TOLERANCE;
+    if (!Valid || (Percent < 0)) {
+        Err << "Invalid tolerance.\n\n" << Parser.helpText();
+        return BENCH_EXIT_USAGE;
+    }
+
+    // Read the baseline first, so a wrong file doesn't waste a whole run
+    QJsonObject BaselineReport;
+    if (Parser.isSet(Baseline)) {
+        QFile           File(Parser.value(Baseline));
+        QJsonParseError ParseError;
+        if (File.open(QIODevice::ReadOnly)) {
+            BaselineReport = QJsonDocument::fromJson(File.readAll(), &ParseError).object();
+        }
+        if (BaselineReport.isEmpty()) {
+            Err << QString("Couldn't read the baseline %1\n").arg(File.fileName());
+            return BENCH_EXIT_USAGE;
+        }
+    }
+
+    QTemporaryDir Temporary;
+    QString       Path = Parser.isSet(Directory) ? Parser.value(Directory) : Temporary.path();
+    if (!QDir().mkpath(Path)) {
+        Err << QString("Couldn't create %1\n").arg(Path);
+        return BENCH_EXIT_FAILURE;
+    }
+
+    QJsonObject Report;
+    QString     Error;
+    bool        Passed = true;
+    if (Parser.isSet(Golden)) {
+        Passed = RegressionCheck::checkGolden(Parser.value(Golden), Parser.isSet(UpdateGolden), &Report);
+    }
+    else if (!Benchmark(Path, Count, Parser.isSet(Quick)).run(&Report, &Error)) {
+        Err << Error << "\n";
+        return BENCH_EXIT_FAILURE;
+    }
+    else if (Parser.isSet(Baseline)) {
+        Passed = RegressionCheck::checkBaseline(Report, BaselineReport, Percent, &Report);
+    }
+    int ExitCode = Passed ? BENCH_EXIT_SUCCESS : BENCH_EXIT_FAILURE;
+
+    QByteArray Json = QJsonDocument(Report).toJson();
+    if (!Parser.isSet(Output)) {
+        QTextStream(stdout) << Json;
+        return ExitCode;
+    }
+
+    QFile File(Parser.value(Output));
+    if (!File.open(QIODevice::WriteOnly | QIODevice::Truncate) || (File.write(Json) != Json.size())) {
+        Err << QString("Couldn't write %1\n").arg(File.fileName());
+        return BENCH_EXIT_FAILURE;
+    }
+    return ExitCode;
+}
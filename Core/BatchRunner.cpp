@@ -0,0 +1,372 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "BatchRunner.hpp"
+#include "DropThread.hpp"
+#include "ErrorLog.hpp"
+#include "FileWalker.hpp"
+#include "JobJournal.hpp"
+#include "ResizeJob.hpp"
+#include "ResizeOptions.hpp"
+#include "ResizeThread.hpp"
+#include "StageMetrics.hpp"
+#include "TraceRecorder.hpp"
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QList>
+#include <QPair>
+#include <QSet>
+#include <QSettings>
+#include <QSize>
+#include <QTextStream>
+#include <QUrl>
+#include <QVector>
+#include <cstring>
+
+//
+//  isBatch
+//
+// Return true if the program is started in command line mode
+//
+
+bool BatchRunner::isBatch(int argc, char* argv[])
+{
+    return (argc > 1) && (std::strcmp(argv[1], BATCH_ARGUMENT) == 0);
+}
+
+//
+//  exec
+//
+// Entry point of the command line mode. The drop thread probes the files, and each valid file is handed to the resize thread
+// as soon as it's probed. The resize thread runs in streaming mode until the drop thread has handled every file.
+// If the resize thread is terminating when new files are probed, they are kept and resized by a new process
+//
+
+int BatchRunner::exec(int argc, char* argv[])
+{
+    QCoreApplication Application(argc, argv);
+    QTextStream      Out(stdout);
+    QTextStream      Err(stderr);
+
+    ResizeParameters Parameters;
+    QStringList      Files;
+    QString          LogFile;
+    QString          MetricsFile;
+    QString          TraceFile;
+    QString          Error;
+    int              TargetSize = -1;
+    bool             Background = false;
+    bool             Resume     = false;
+    if (!parseArguments(QCoreApplication::arguments(), &Parameters, &Files, &LogFile, &MetricsFile, &TraceFile, &TargetSize, &Background, &Resume, &Error)) {
+        Err << Error << "\n";
+        return BATCH_EXIT_USAGE;
+    }
+    ErrorLog::setLogFile(LogFile.isEmpty() ? QSettings().value("Errors/LogFile").toString() : LogFile);
+    TraceRecorder::start(TraceFile.isEmpty() ? QSettings().value("Trace/File").toString() : TraceFile);
+
+    // Filenames are indexed by job id. Processes counts the resizing processes started and not terminated yet.
+    // ReasonCounts sums the failures of all the processes, by reason, and Metrics their stage measures
+    ResizeOptions    Options   = ResizeOptions::fromSettings();
+    DropThread*      Prober    = DropThread::instance();
+    ResizeThread*    Resizer   = ResizeThread::instance();
+    QStringList      Filenames;
+    QList<ResizeJob> Backlog;
+    ErrorLog         DropErrors;
+    QVector<int>     ReasonCounts(ErrorRecords::ReasonCount, 0);
+    StageStatistics  Metrics;
+    bool             Probing   = true;
+    int              Processes = 0;
+    int              Processed = 0;
+    int              Failures  = 0;
+
+    // The command line may ask for the background mode on top of the settings, and override the file size budget
+    Options.Background |= Background;
+    if (TargetSize != -1) {
+        Options.TargetSize = TargetSize;
+    }
+
+    // Write a line per file
+    auto report = [&](const QString& filename, bool success, const QString& status) {
+        Processed++;
+        Failures += success ? 0 : 1;
+        Out << QString("[%1/%2] %3: %4\n").arg(Processed).arg(Files.count()).arg(filename, status);
+        Out.flush();
+    };
+
+    // Quit once every file has been probed and resized
+    auto checkTermination = [&]() {
+        if (!Probing && (Processes == 0) && Backlog.isEmpty()) {
+            Application.quit();
+        }
+    };
+
+    // Give the probed files to the resize thread.
+    // Signals are emitted by the threads. The application is the context of the connections, so the lambdas run in the main thread
+    QObject::connect(Prober, &DropThread::dropResultReady, &Application, [&]() {
+        QList<QPair<QString, QSize>> Result;
+        QStringList                  Oversized;
+        Prober->result(&Result, &Oversized);
+        for (const QString& Filename : Oversized) {
+            DropErrors.append(Filename, ErrorRecords::StageDrop, ErrorRecords::ReasonTooLarge);
+            ReasonCounts[ErrorRecords::ReasonTooLarge]++;
+            report(Filename, false, ErrorRecords::reasonName(ErrorRecords::ReasonTooLarge));
+        }
+
+        QList<ResizeJob> Jobs;
+        for (const QPair<QString, QSize>& File : Result) {
+            if (!File.second.isValid()) {
+                DropErrors.append(File.first, ErrorRecords::StageDrop, ErrorRecords::ReasonUnreadable);
+                ReasonCounts[ErrorRecords::ReasonUnreadable]++;
+                report(File.first, false, ErrorRecords::reasonName(ErrorRecords::ReasonUnreadable));
+                continue;
+            }
+            Jobs << ResizeJob {int(Filenames.count()), File.first, File.second, Parameters.newSize(File.second)};
+            Filenames << File.first;
+        }
+
+        if (Jobs.isEmpty()) {
+            return;
+        }
+        if (Processes == 0) {
+            Processes++;
+            Resizer->resize(Jobs, Options, Probing);
+        }
+        else if (!Resizer->enqueue(Jobs)) {
+            Backlog << Jobs;
+        }
+    });
+
+    // No more files: let the resize thread terminate once the queued ones are done
+    QObject::connect(Prober, &DropThread::dropProcessTerminaded, &Application, [&]() {
+        Probing = false;
+        if (Processes != 0) {
+            Resizer->closeInput();
+        }
+        checkTermination();
+    });
+
+    QObject::connect(Resizer, &ResizeThread::fileResized, &Application, [&](int id, bool success) { report(Filenames.at(id), success, success ? "resized" : "failed"); });
+
+    // Resize the files probed while the process was terminating
+    QObject::connect(Resizer, &ResizeThread::resizingTerminated, &Application, [&]() {
+        Processes--;
+        ErrorRecords Errors = Resizer->errors();
+        for (int i = 0; i < ErrorRecords::ReasonCount; i++) {
+            ReasonCounts[i] += Errors.count(ErrorRecords::Reason(i));
+        }
+        Metrics.merge(Resizer->metrics());
+        if (!Backlog.isEmpty()) {
+            Processes++;
+            Resizer->resize(Backlog, Options, Probing);
+            Backlog.clear();
+        }
+        checkTermination();
+    });
+
+    // Resume: the unfinished jobs of the journal are resized with the new sizes they were given, without probing.
+    // Otherwise, they are dropped from the journal when the first new jobs are planned
+    if (Resume) {
+        QList<ResizeJob> Jobs = JobJournal::instance()->unfinishedJobs();
+        for (ResizeJob& Job : Jobs) {
+            Job.Id = Filenames.count();
+            Filenames << Job.Filename;
+        }
+        Files   = Filenames;
+        Probing = false;
+        if (!Jobs.isEmpty()) {
+            Processes++;
+            Resizer->resize(Jobs, Options);
+        }
+        else {
+            Out << "Nothing to resume\n";
+        }
+    }
+    else {
+        int Unfinished = JobJournal::instance()->unfinishedJobs().count();
+        if (Unfinished != 0) {
+            Err << QString("%1 unfinished jobs of the previous run are discarded. Use --resume to resize them.\n").arg(Unfinished);
+        }
+
+        QList<QUrl> Urls;
+        for (const QString& Filename : Files) {
+            Urls << QUrl::fromLocalFile(Filename);
+        }
+        Prober->setLimits(Options.Limits);
+        Prober->drop(Urls);
+    }
+    if (Probing || (Processes != 0)) {
+        Application.exec();
+    }
+
+    Prober->wait();
+    Resizer->wait();
+    ErrorLog::flushLogFile();
+
+    // Summary, with the failures by reason
+    Out << QString("%1 files processed, %2 failed\n").arg(Processed).arg(Failures);
+    for (int i = 0; i < ErrorRecords::ReasonCount; i++) {
+        if (ReasonCounts.at(i) != 0) {
+            Out << QString("    %1: %2\n").arg(ErrorRecords::reasonName(ErrorRecords::Reason(i))).arg(ReasonCounts.at(i));
+        }
+    }
+
+    // Stage measures of the whole batch. Probes of files which were never resized are taken from the collector
+    if (!MetricsFile.isEmpty()) {
+        Metrics.merge(StageMetrics::instance()->take());
+        Out << Metrics.summary() << "\n";
+        if (!Metrics.write(MetricsFile)) {
+            Err << QString("Couldn't write %1\n").arg(MetricsFile);
+        }
+    }
+    Out.flush();
+
+    if (!TraceRecorder::stop()) {
+        Err << "Couldn't write the trace file\n";
+    }
+    DropThread::release();
+    ResizeThread::release();
+    return Failures == 0 ? BATCH_EXIT_SUCCESS : BATCH_EXIT_FAILURE;
+}
+
+//
+//  parseArguments
+//
+// Read the resizing method, the files to process, the log and report files, the file size budget and the modes. Directories are expanded,
+// and files given more than once are resized once.
+// With --resume, there is neither file nor method to read. The budget is -1 if not given.
+// Return false and an explanation if the command line is invalid
+//
+
+bool BatchRunner::parseArguments(const QStringList& arguments, ResizeParameters* parameters, QStringList* files, QString* logfile, QString* metricsfile, QString* tracefile, int* targetsize, bool* background, bool* resume, QString* error)
+{
+    QCommandLineParser Parser;
+    QCommandLineOption Batch(QString(BATCH_ARGUMENT).mid(2), "Resize from the command line, without GUI.");
+    QCommandLineOption Percentage(QStringList {"p", "percentage"}, "Resize the pictures to a percentage of their size (1-99).", "percentage");
+    QCommandLineOption Size(QStringList {"s", "size"}, "Set the largest side of the pictures to a number of pixels (1-9999).", "pixels");
+    QCommandLineOption Log("error-log", "Append the failed files to a log file, as they fail. Overrides the Errors/LogFile setting.", "file");
+    QCommandLineOption Metrics("metrics", "Write the time, bytes and pixels of each processing stage to a file, as CSV if it ends with .csv, else as JSON.", "file");
+    QCommandLineOption Trace("trace", "Write the timeline of the workers to a Chrome trace file. Overrides the Trace/File setting.", "file");
+    QCommandLineOption TargetSize("target-size", "Encode the pictures with the best quality which fits in a number of KB, 0 to disable. Overrides the Resize/TargetSize setting.", "KB");
+    QCommandLineOption Background("background", "Run at low CPU and I/O priority, with fewer workers, backing off when the machine is busy. Same as the Resize/Background setting.");
+    QCommandLineOption Resume("resume", "Resize the files left unfinished by the previous run, with the new sizes they were given, instead of new files.");
+    Parser.setApplicationDescription("Resize pictures. Original pictures are overwritten.");
+    Parser.addOption(Batch);
+    Parser.addOption(Percentage);
+    Parser.addOption(Size);
+    Parser.addOption(Log);
+    Parser.addOption(Metrics);
+    Parser.addOption(Trace);
+    Parser.addOption(TargetSize);
+    Parser.addOption(Background);
+    Parser.addOption(Resume);
+    Parser.addPositionalArgument("files", "Pictures, or directories containing pictures.", "<files...>");
+
+    if (!Parser.parse(arguments)) {
+        *error = Parser.errorText() + "\n\n" + Parser.helpText();
+        return false;
+    }
+    if (Parser.isSet(Percentage) && Parser.isSet(Size)) {
+        *error = "--percentage and --size can't be used together.\n\n" + Parser.helpText();
+        return false;
+    }
+    if (Parser.isSet(Resume) && (Parser.isSet(Percentage) || Parser.isSet(Size) || !Parser.positionalArguments().isEmpty())) {
+        *error = "--resume takes neither files nor resizing method: they are read from the journal.\n\n" + Parser.helpText();
+        return false;
+    }
+    if (Parser.positionalArguments().isEmpty() && !Parser.isSet(Resume)) {
+        *error = "No file given.\n\n" + Parser.helpText();
+        return false;
+    }
+
+    // Read the resizing method. Ranges are the ones of the GUI
+    bool Valid = true;
+    if (Parser.isSet(Size)) {
+        int Value   = Parser.value(Size).toInt(&Valid);
+        Valid       = Valid && (Value >= 1) && (Value <= 9999);
+        *parameters = ResizeParameters(ResizeParameters::MethodAbsoluteSize, parameters->Percentage, Value);
+    }
+    else if (Parser.isSet(Percentage)) {
+        int Value   = Parser.value(Percentage).toInt(&Valid);
+        Valid       = Valid && (Value >= 1) && (Value <= 99);
+        *parameters = ResizeParameters(ResizeParameters::MethodPercentage, Value, parameters->AbsoluteSize);
+    }
+    if (!Valid) {
+        *error = "Invalid resizing value.\n\n" + Parser.helpText();
+        return false;
+    }
+
+    *targetsize = -1;
+    if (Parser.isSet(TargetSize)) {
+        *targetsize = Parser.value(TargetSize).toInt(&Valid);
+        if (!Valid || (*targetsize < 0)) {
+            *error = "Invalid file size budget.\n\n" + Parser.helpText();
+            return false;
+        }
+    }
+
+    *logfile     = Parser.value(Log);
+    *metricsfile = Parser.value(Metrics);
+    *tracefile   = Parser.value(Trace);
+    *background  = Parser.isSet(Background);
+    *resume      = Parser.isSet(Resume);
+    if (*resume) {
+        return true;
+    }
+
+    // Expand the directories
+    for (const QString& Argument : Parser.positionalArguments()) {
+        QFileInfo Info(Argument);
+        if (Info.isFile()) {
+            *files << Info.absoluteFilePath();
+        }
+        else if (Info.isDir()) {
+            FileWalker::getFiles(*files, Info.absoluteFilePath(), true);
+        }
+        else {
+            *error = QString("No such file or directory: %1").arg(Argument);
+            return false;
+        }
+    }
+
+    // Overlapping arguments (a directory and one of its subdirectories, a file given twice, a symbolic link) would give
+    // two jobs for the same file, overwriting it concurrently. Keep the first occurrence of each canonical path
+    QSet<QString> Canonical;
+    QStringList   Unique;
+    Canonical.reserve(files->count());
+    for (const QString& Filename : *files) {
+        QString Path = QFileInfo(Filename).canonicalFilePath();
+        if (Path.isEmpty()) {
+            Path = Filename;
+        }
+        if (!Canonical.contains(Path)) {
+            Canonical.insert(Path);
+            Unique << Filename;
+        }
+    }
+    *files = Unique;
+
+    if (files->isEmpty()) {
+        *error = "No picture found.";
+        return false;
+    }
+    return true;
+}
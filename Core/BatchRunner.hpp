@@ -0,0 +1,66 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef BATCHRUNNER_HPP
+#define BATCHRUNNER_HPP
+
+#include "ResizeParameters.hpp"
+#include <QString>
+#include <QStringList>
+
+//
+//  BatchRunner
+//
+// This class implements the command line mode, for scripts and hot folders:
+//   PicRes --batch [--percentage N | --size N] [--error-log file] [--metrics file] [--trace file] [--background] <files or directories>
+//   PicRes --batch --resume [--error-log file] [--metrics file] [--trace file] [--background]
+// No GUI is created. Files are resized in streaming mode: each file becomes a job as soon as it has been probed,
+// so resizing starts while the remaining files are still being read. Engine settings and limits are read from the settings file.
+// Progress is written on stdout, one line per file.
+// With --resume, the jobs left unfinished by an interrupted run are read from the job journal and resized without probing.
+//
+// Exit code: 0 if every file has been resized, 1 if some couldn't, 2 if the command line is invalid
+//
+
+class BatchRunner
+{
+  public:
+    static bool isBatch(int argc, char* argv[]); // Return true if the program is started in command line mode
+    static int  exec(int argc, char* argv[]);    // Entry point of the command line mode. Return when all files are processed
+
+  private:
+    static bool parseArguments(const QStringList& arguments, ResizeParameters* parameters, QStringList* files, QString* logfile, QString* metricsfile, QString* tracefile, int* targetsize, bool* background, bool* resume, QString* error); // Read the resizing method, the files to process, the error log, the report files, the file size budget and the modes
+};
+
+//
+//  Command line switch starting the command line mode
+//
+
+#define BATCH_ARGUMENT "--batch"
+
+//
+//  Exit codes of the command line mode
+//
+
+#define BATCH_EXIT_SUCCESS 0
+#define BATCH_EXIT_FAILURE 1
+#define BATCH_EXIT_USAGE 2
+
+#endif // BATCHRUNNER_HPP
@@ -0,0 +1,289 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "BufferPool.hpp"
+#include <QMutexLocker>
+#include <QPixelFormat>
+#include <climits>
+#include <cstdlib>
+#include <utility>
+
+//
+//  Each buffer is preceded by a header holding its size class. 64 bytes keep the pixels aligned on a cache line
+//  when the allocator aligns on 64, and on 16 bytes otherwise
+//
+
+#define BUFFER_HEADER_SIZE 64
+
+namespace {
+
+    //
+    //  recycleImage
+    //
+    // Cleanup function of the images created by the pool. Called when the last copy of an image is destroyed
+    //
+
+    void recycleImage(void* buffer)
+    {
+        BufferPool::instance()->recycle(static_cast<uchar*>(buffer));
+    }
+
+} // namespace
+
+//
+//  BufferPool
+//
+// Constructor
+//
+
+BufferPool::BufferPool()
+    : Capacity(qint64(DEFAULT_BUFFER_POOL_SIZE) * 1024 * 1024)
+    , Retained(0)
+    , Hits(0)
+    , Misses(0)
+{
+}
+
+//
+//  ~BufferPool
+//
+// Destructor. Free the retained buffers
+//
+
+BufferPool::~BufferPool()
+{
+    clear();
+}
+
+//
+//  instance
+//
+// Return the unique instance. Like the weight cache, it's a function-local static, first used by the workers
+//
+
+BufferPool* BufferPool::instance()
+{
+    static BufferPool Instance;
+    return &Instance;
+}
+
+//
+//  sizeClass
+//
+// Return the smallest class able to hold size bytes. Classes grow by a quarter of a power of two,
+// so a buffer wastes at most 25% of its size
+//
+
+int BufferPool::sizeClass(qint64 size)
+{
+    int SizeClass = 0;
+    while (classCapacity(SizeClass) < size) {
+        SizeClass++;
+    }
+    return SizeClass;
+}
+
+//
+//  classCapacity
+//
+// Return the buffer size of a class: 1 KB, 1.25 KB, 1.5 KB, 1.75 KB, 2 KB, 2.5 KB...
+//
+
+qint64 BufferPool::classCapacity(int sizeclass)
+{
+    return qint64(4 + (sizeclass & 3)) << ((sizeclass >> 2) + 8);
+}
+
+//
+//  acquire
+//
+// Borrow a buffer of at least size bytes, from the pool if a buffer of the same class is available.
+// New buffers are allocated outside of the lock
+//
+
+uchar* BufferPool::acquire(qint64 size)
+{
+    int SizeClass = sizeClass(size);
+    {
+        QMutexLocker     Locker(&this->Mutex);
+        QVector<uchar*>& Buffers = this->FreeBuffers[SizeClass];
+        if (!Buffers.isEmpty()) {
+            uchar* Buffer = Buffers.takeLast();
+            this->Retained -= classCapacity(SizeClass);
+            this->Hits++;
+            return Buffer;
+        }
+        this->Misses++;
+    }
+
+    uchar* Base = static_cast<uchar*>(std::malloc(size_t(classCapacity(SizeClass) + BUFFER_HEADER_SIZE)));
+    if (Base == nullptr) {
+        return nullptr;
+    }
+    *reinterpret_cast<qint64*>(Base) = SizeClass;
+    return Base + BUFFER_HEADER_SIZE;
+}
+
+//
+//  recycle
+//
+// Give a buffer back. If needed to stay under the capacity, retained buffers are freed first, largest classes first
+// (see trim()): the buffer returned last is kept, as it's the most likely to match the next picture
+//
+
+void BufferPool::recycle(uchar* buffer)
+{
+    if (buffer == nullptr) {
+        return;
+    }
+
+    uchar* Base      = buffer - BUFFER_HEADER_SIZE;
+    int    SizeClass = int(*reinterpret_cast<qint64*>(Base));
+    qint64 Size      = classCapacity(SizeClass);
+
+    QMutexLocker Locker(&this->Mutex);
+    if (Size > this->Capacity) {
+        std::free(Base);
+        return;
+    }
+
+    trim(Size);
+    this->FreeBuffers[SizeClass] << buffer;
+    this->Retained += Size;
+}
+
+//
+//  image
+//
+// Return an image over a pooled buffer. Scanlines are 32-bit aligned, as QImage requires.
+// Formats with a palette and sub-byte formats are not pooled: they are small, and need a color table
+//
+
+QImage BufferPool::image(QSize size, QImage::Format format)
+{
+    int Depth = QImage::toPixelFormat(format).bitsPerPixel();
+    if (size.isEmpty() || (format == QImage::Format_Invalid) || (format == QImage::Format_Indexed8) || (Depth < 8)) {
+        return QImage(size, format);
+    }
+
+    qint64 BytesPerLine = ((qint64(size.width()) * Depth + 31) / 32) * 4;
+    if (BytesPerLine > INT_MAX) {
+        return QImage();
+    }
+
+    uchar* Buffer = acquire(BytesPerLine * size.height());
+    if (Buffer == nullptr) {
+        return QImage();
+    }
+
+    QImage Image(Buffer, size.width(), size.height(), int(BytesPerLine), format, recycleImage, Buffer);
+    if (Image.isNull()) {
+        recycle(Buffer);
+    }
+    return Image;
+}
+
+//
+//  setCapacity
+//
+// Set the maximum number of bytes retained by the pool, freeing buffers if needed
+//
+
+void BufferPool::setCapacity(qint64 bytes)
+{
+    QMutexLocker Locker(&this->Mutex);
+    this->Capacity = qMax(bytes, qint64(0));
+    trim(0);
+}
+
+//
+//  clear
+//
+// Free all the retained buffers. Buffers in use are not affected, they will be retained when they come back
+//
+
+void BufferPool::clear()
+{
+    QMutexLocker Locker(&this->Mutex);
+    for (const QVector<uchar*>& Buffers : std::as_const(this->FreeBuffers)) {
+        for (uchar* Buffer : Buffers) {
+            std::free(Buffer - BUFFER_HEADER_SIZE);
+        }
+    }
+    this->FreeBuffers.clear();
+    this->Retained = 0;
+}
+
+//
+//  trim
+//
+// Free retained buffers, largest classes first, until bytes more can be retained without exceeding the capacity
+//
+
+void BufferPool::trim(qint64 bytes)
+{
+    while ((this->Retained > 0) && (this->Retained + bytes > this->Capacity)) {
+        int Largest = -1;
+        for (auto it = this->FreeBuffers.constBegin(); it != this->FreeBuffers.constEnd(); ++it) {
+            if (!it.value().isEmpty() && (it.key() > Largest)) {
+                Largest = it.key();
+            }
+        }
+
+        std::free(this->FreeBuffers[Largest].takeLast() - BUFFER_HEADER_SIZE);
+        this->Retained -= classCapacity(Largest);
+    }
+}
+
+//
+//  retainedBytes
+//
+// Return the number of bytes retained by the pool
+//
+
+qint64 BufferPool::retainedBytes() const
+{
+    QMutexLocker Locker(&this->Mutex);
+    return this->Retained;
+}
+
+//
+//  hits
+//
+// Return the number of buffers served from the pool
+//
+
+int BufferPool::hits() const
+{
+    QMutexLocker Locker(&this->Mutex);
+    return this->Hits;
+}
+
+//
+//  misses
+//
+// Return the number of buffers allocated
+//
+
+int BufferPool::misses() const
+{
+    QMutexLocker Locker(&this->Mutex);
+    return this->Misses;
+}
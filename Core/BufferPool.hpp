@@ -0,0 +1,73 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef BUFFERPOOL_HPP
+#define BUFFERPOOL_HPP
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QVector>
+
+//
+//  BufferPool
+//
+// This class recycles the large pixel buffers of the resize workers. A 24 Mpx picture needs a 96 MB buffer: allocating it
+// for each file means an mmap, then a page fault for every 4 KB touched, then an munmap. Recycled buffers are already mapped.
+// Buffers are grouped in size classes (four per power of two), so pictures of slightly different sizes share buffers.
+// The pool retains at most a given number of bytes; beyond that, returned buffers are freed
+//
+
+class BufferPool
+{
+  public:
+    static BufferPool* instance();                               // Return the unique instance, created on first use
+    uchar*             acquire(qint64 size);                     // Borrow a buffer of at least size bytes. Return nullptr if allocation fails
+    void               recycle(uchar* buffer);                   // Give a buffer back to the pool
+    QImage             image(QSize size, QImage::Format format); // Return an image over a pooled buffer. The buffer is recycled when the image is destroyed
+    void               setCapacity(qint64 bytes);                // Maximum number of bytes retained by the pool
+    void               clear();                                  // Free all the retained buffers
+    qint64             retainedBytes() const;                    // Number of bytes retained by the pool
+    int                hits() const;                             // Number of buffers served from the pool
+    int                misses() const;                           // Number of buffers allocated
+
+  private:
+    BufferPool();
+    ~BufferPool();
+    static int    sizeClass(qint64 size);       // Size class of a buffer size
+    static qint64 classCapacity(int sizeclass); // Buffer size of a class
+    void          trim(qint64 bytes);           // Free retained buffers until bytes can be retained. Mutex must be locked
+
+    QHash<int, QVector<uchar*>> FreeBuffers; // Retained buffers, per size class
+    qint64                      Capacity;    // Maximum number of retained bytes
+    qint64                      Retained;    // Number of retained bytes
+    mutable QMutex              Mutex;       // Control access to the pool and counters
+    int                         Hits;        // Allocation statistics
+    int                         Misses;      //
+};
+
+//
+//  Default number of bytes retained by the pool, in MB
+//
+
+#define DEFAULT_BUFFER_POOL_SIZE 512
+
+#endif // BUFFERPOOL_HPP
@@ -0,0 +1,113 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "ColorTransformCache.hpp"
+#include <QCryptographicHash>
+#include <QMutexLocker>
+#include <QRgb>
+#include <QRgba64>
+
+//
+//  ColorTransformCache
+//
+// Constructor
+//
+
+ColorTransformCache::ColorTransformCache()
+    : Cache(COLOR_TRANSFORM_CACHE_SIZE)
+{
+}
+
+//
+//  instance
+//
+// Return the unique instance. Like the weight cache, it's a function-local static:
+// it's first used by the workers, and its construction must be thread-safe
+//
+
+ColorTransformCache* ColorTransformCache::instance()
+{
+    static ColorTransformCache Instance;
+    return &Instance;
+}
+
+//
+//  toSrgb
+//
+// Return the transform converting a color space to sRGB. Null if the color space is unknown or already sRGB.
+// On a miss, the transform is built outside of the lock so workers don't wait for each other;
+// if two workers build the same transform, the first one inserted wins.
+// Qt builds the lookup tables of a transform when it's first used: a few colors are converted before it's shared,
+// so the workers don't race to build them
+//
+
+ColorTransformCache::Transform ColorTransformCache::toSrgb(const QColorSpace& colorspace)
+{
+    if (!colorspace.isValid() || (colorspace == QColorSpace(QColorSpace::SRgb))) {
+        return Transform();
+    }
+    QByteArray Key = key(colorspace);
+
+    this->Mutex.lock();
+    Transform* Cached = this->Cache.object(Key);
+    if (Cached != nullptr) {
+        Transform Result = *Cached;
+        this->Mutex.unlock();
+        return Result;
+    }
+    this->Mutex.unlock();
+
+    QColorTransform* Built = new QColorTransform(colorspace.transformationToColorSpace(QColorSpace(QColorSpace::SRgb)));
+    Built->map(qRgb(0x80, 0x80, 0x80));
+    Built->map(QRgba64::fromRgba64(0x8000, 0x8000, 0x8000, 0xFFFF));
+    Transform Computed(Built);
+
+    QMutexLocker Locker(&this->Mutex);
+    Cached = this->Cache.object(Key);
+    if (Cached != nullptr) {
+        return *Cached;
+    }
+    this->Cache.insert(Key, new Transform(Computed));
+    return Computed;
+}
+
+//
+//  clear
+//
+// Discard all the transforms. Transforms still used by a worker stay alive until it has finished
+//
+
+void ColorTransformCache::clear()
+{
+    QMutexLocker Locker(&this->Mutex);
+    this->Cache.clear();
+}
+
+//
+//  key
+//
+// Return the hash of the ICC profile of a color space. Profiles read from files are kept as they are by Qt,
+// so pictures from the same camera or editor give the same key
+//
+
+QByteArray ColorTransformCache::key(const QColorSpace& colorspace)
+{
+    return QCryptographicHash::hash(colorspace.iccProfile(), QCryptographicHash::Sha1);
+}
@@ -0,0 +1,63 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef COLORTRANSFORMCACHE_HPP
+#define COLORTRANSFORMCACHE_HPP
+
+#include <QByteArray>
+#include <QCache>
+#include <QColorSpace>
+#include <QColorTransform>
+#include <QMutex>
+#include <QSharedPointer>
+
+//
+//  ColorTransformCache
+//
+// This class is a thread-safe cache of the transforms converting pictures to sRGB, shared by all the resize workers.
+// Building a transform and its lookup tables costs much more than applying it to a resampled picture,
+// and most batches use only one or two profiles: each transform is built for the first picture with its profile,
+// then reused. Transforms are keyed by a hash of the ICC profile, so pictures with the same profile share one
+//
+
+class ColorTransformCache
+{
+  public:
+    typedef QSharedPointer<const QColorTransform> Transform;
+
+    static ColorTransformCache* instance();                            // Return the unique instance, created on first use
+    Transform                   toSrgb(const QColorSpace& colorspace); // Return the transform from a color space to sRGB, building it if needed. Null if there is nothing to convert
+    void                        clear();                               // Discard all the transforms
+
+  private:
+    ColorTransformCache();
+    static QByteArray key(const QColorSpace& colorspace); // Hash of the ICC profile of a color space
+
+    QCache<QByteArray, Transform> Cache; // Cached transforms
+    QMutex                        Mutex; // Control access to the cache
+};
+
+//
+//  Number of cached transforms
+//
+
+#define COLOR_TRANSFORM_CACHE_SIZE 16
+
+#endif // COLORTRANSFORMCACHE_HPP
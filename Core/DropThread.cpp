@@ -19,6 +19,9 @@
  */
 
 #include "DropThread.hpp"
+#include "StageMetrics.hpp"
+#include "TraceRecorder.hpp"
+#include <QElapsedTimer>
 #include <QImageReader>
 
 //
@@ -102,11 +105,28 @@ void DropThread::run()
         // Emit a signal to say to the main UI which file is being processed
         emit processingDroppedFile(Filename);
 
-        // Add the picture filename and its size to the result list. Size is invalid if the picture couldn't be read
+        // Add the picture filename and its size to the result list. Size is invalid if the picture couldn't be read.
+        // Pictures exceeding the limits are rejected from their header, before anything is decoded.
+        // Only the header is read, so the probe is measured in files and pixels, not in bytes
+        this->MutexQueue.lock();
+        ImageLimits Limits = this->Limits;
+        this->MutexQueue.unlock();
+
+        TraceScope    Trace("probe", -1);
+        QElapsedTimer Timer;
+        Timer.start();
         QImageReader Image(Filename);
-        QSize        Size(Image.canRead() ? Image.size() : QSize());
+        Limits.apply(Image);
+        QSize Size(Image.canRead() ? Image.size() : QSize());
+        StageMetrics::instance()->record(StageStatistics::StageProbe, Timer.nsecsElapsed(), 0, Size.isValid() ? qint64(Size.width()) * Size.height() : 0);
+        Trace.finish();
         this->MutexResult.lock();
-        this->Result << QPair<QString, QSize>(Filename, Size);
+        if (Limits.accepts(Size)) {
+            this->Result << QPair<QString, QSize>(Filename, Size);
+        }
+        else {
+            this->Oversized << Filename;
+        }
         this->MutexResult.unlock();
 
         // Emit a signal to say that at least one result is available
@@ -129,10 +149,25 @@ void DropThread::run()
 // Support empty result list, because process and UI are asynchroneous
 //
 
-void DropThread::result(QList<QPair<QString, QSize>>* result)
+void DropThread::result(QList<QPair<QString, QSize>>* result, QStringList* oversized)
 {
     this->MutexResult.lock();
-    *result = this->Result;     // Available results are copied into the caller variable
-    this->Result.clear();       // And discarded from this object
-    this->MutexResult.unlock(); //
+    *result    = this->Result;    // Available results are copied into the caller variables
+    *oversized = this->Oversized; //
+    this->Result.clear();         // And discarded from this object
+    this->Oversized.clear();      //
+    this->MutexResult.unlock();   //
+}
+
+//
+//  setLimits
+//
+// Set the limits checked on the dropped files. They are taken into account from the next file
+//
+
+void DropThread::setLimits(ImageLimits limits)
+{
+    this->MutexQueue.lock();
+    this->Limits = limits;
+    this->MutexQueue.unlock();
 }
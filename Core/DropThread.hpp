@@ -21,10 +21,12 @@
 #ifndef DROPTHREAD_HPP
 #define DROPTHREAD_HPP
 
+#include "ImageLimits.hpp"
 #include <QList>
 #include <QMutex>
 #include <QSize>
 #include <QString>
+#include <QStringList>
 #include <QThread>
 #include <QUrl>
 
@@ -39,10 +41,11 @@ class DropThread: public QThread
     Q_OBJECT
 
   public:
-    static DropThread* instance();                                   // Return a ptr to the object instance; create it if needed
-    static void        release();                                    // Delete the thread if it was created
-    void               drop(QList<QUrl> URLs);                       // Called when the main UI receives files
-    void               result(QList<QPair<QString, QSize>>* result); // Gives the result processed by the worker thread
+    static DropThread* instance();                                                           // Return a ptr to the object instance; create it if needed
+    static void        release();                                                            // Delete the thread if it was created
+    void               drop(QList<QUrl> URLs);                                               // Called when the main UI receives files
+    void               result(QList<QPair<QString, QSize>>* result, QStringList* oversized); // Gives the result processed by the worker thread, and the files exceeding the limits
+    void               setLimits(ImageLimits limits);                                        // Set the limits checked on the dropped files
 
   private:
     void run() override; // Worker
@@ -50,7 +53,9 @@ class DropThread: public QThread
     static DropThread*           dropthread;  // Singleton pointer
     QList<QUrl>                  Queue;       // Store the URLs dropped into the UI
     QList<QPair<QString, QSize>> Result;      // Store the result of the worker thread
-    QMutex                       MutexQueue;  // Control access to the queue list
+    QStringList                  Oversized;   // Files rejected because they exceed the limits
+    ImageLimits                  Limits;      // Limits checked on the dropped files
+    QMutex                       MutexQueue;  // Control access to the queue list and the limits
     QMutex                       MutexResult; // Control access to the result list
 
   signals:
@@ -0,0 +1,313 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "ErrorLog.hpp"
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutexLocker>
+
+namespace {
+
+    //
+    //  LogSink
+    //
+    // Log file shared by all the error lists. Records are buffered, and flushed at most every ERROR_LOG_FLUSH_INTERVAL ms,
+    // so a share producing thousands of failures per second doesn't make the workers wait for the log
+    //
+
+    struct LogSink
+    {
+        QFile         File;       // Log file, not open if logging is disabled
+        QElapsedTimer FlushTimer; // Time since the last flush
+        QMutex        Mutex;      // Control access to the file
+    };
+
+    LogSink& logSink()
+    {
+        static LogSink Sink;
+        return Sink;
+    }
+
+} // namespace
+
+//
+//  ErrorRecords
+//
+// Constructor
+//
+
+ErrorRecords::ErrorRecords()
+    : ReasonCounts(ReasonCount, 0)
+{
+}
+
+//
+//  count
+//
+// Return the number of records
+//
+
+int ErrorRecords::count() const
+{
+    return this->Records.count();
+}
+
+//
+//  count
+//
+// Return the number of records with a given reason
+//
+
+int ErrorRecords::count(Reason reason) const
+{
+    return reason < ReasonCount ? this->ReasonCounts.at(reason) : 0;
+}
+
+//
+//  isEmpty
+//
+// Return true if there is no record
+//
+
+bool ErrorRecords::isEmpty() const
+{
+    return this->Records.isEmpty();
+}
+
+//
+//  append
+//
+// Add a record. The path is appended to the pool
+//
+
+void ErrorRecords::append(const QString& filename, Stage stage, Reason reason)
+{
+    QString Filename = filename.left(0xFFFF);
+    this->Records << Record {quint32(this->NamePool.size()), quint16(Filename.size()), quint8(stage), quint8(reason)};
+    this->NamePool.append(Filename);
+    if (reason < ReasonCount) {
+        this->ReasonCounts[reason]++;
+    }
+}
+
+//
+//  clear
+//
+// Remove all the records and release the memory
+//
+
+void ErrorRecords::clear()
+{
+    this->NamePool.clear();
+    this->NamePool.squeeze();
+    this->Records.clear();
+    this->Records.squeeze();
+    this->ReasonCounts.fill(0);
+}
+
+//
+//  filename
+//
+// Return the path of the file of a record
+//
+
+QString ErrorRecords::filename(int index) const
+{
+    const Record& Current = this->Records.at(index);
+    return this->NamePool.mid(Current.Offset, Current.Length);
+}
+
+//
+//  stage
+//
+// Return the stage at which the file of a record failed
+//
+
+ErrorRecords::Stage ErrorRecords::stage(int index) const
+{
+    return Stage(this->Records.at(index).Stage);
+}
+
+//
+//  reason
+//
+// Return the reason of a record
+//
+
+ErrorRecords::Reason ErrorRecords::reason(int index) const
+{
+    return Reason(this->Records.at(index).Reason);
+}
+
+//
+//  stageName
+//
+// Return the name of a stage, used in log files
+//
+
+QString ErrorRecords::stageName(Stage stage)
+{
+    switch (stage) {
+        case StageDrop:
+            return "drop";
+        case StageRead:
+            return "read";
+        case StageProcess:
+            return "process";
+        case StageWrite:
+            return "write";
+        case StageQueue:
+            return "queue";
+    }
+    return "unknown";
+}
+
+//
+//  reasonName
+//
+// Return the name of a reason, used in log files
+//
+
+QString ErrorRecords::reasonName(Reason reason)
+{
+    switch (reason) {
+        case ReasonNone:
+            return "none";
+        case ReasonUnreadable:
+            return "unreadable";
+        case ReasonTooLarge:
+            return "too-large";
+        case ReasonTimeout:
+            return "timeout";
+        case ReasonDecodeFailed:
+            return "decode-failed";
+        case ReasonEncodeFailed:
+            return "encode-failed";
+        case ReasonWriteFailed:
+            return "write-failed";
+        case ReasonCrashed:
+            return "crashed";
+        case ReasonNotProcessed:
+            return "not-processed";
+        case ReasonCount:
+            break;
+    }
+    return "unknown";
+}
+
+//
+//  append
+//
+// Add a record. If a log file is set, the record is written to it at once: date, stage, reason and path, tab-separated
+//
+
+void ErrorLog::append(const QString& filename, ErrorRecords::Stage stage, ErrorRecords::Reason reason)
+{
+    {
+        QMutexLocker Locker(&this->Mutex);
+        this->Records.append(filename, stage, reason);
+    }
+
+    LogSink&     Sink = logSink();
+    QMutexLocker Locker(&Sink.Mutex);
+    if (Sink.File.isOpen()) {
+        QString Line = QString("%1\t%2\t%3\t%4\n")
+                           .arg(QDateTime::currentDateTime().toString(Qt::ISODate), ErrorRecords::stageName(stage), ErrorRecords::reasonName(reason), filename);
+        Sink.File.write(Line.toUtf8());
+        if (Sink.FlushTimer.hasExpired(ERROR_LOG_FLUSH_INTERVAL)) {
+            Sink.File.flush();
+            Sink.FlushTimer.start();
+        }
+    }
+}
+
+//
+//  clear
+//
+// Remove all the records. Lines already written to the log file are kept
+//
+
+void ErrorLog::clear()
+{
+    QMutexLocker Locker(&this->Mutex);
+    this->Records.clear();
+}
+
+//
+//  isEmpty
+//
+// Return true if there is no record
+//
+
+bool ErrorLog::isEmpty() const
+{
+    QMutexLocker Locker(&this->Mutex);
+    return this->Records.isEmpty();
+}
+
+//
+//  records
+//
+// Return a copy of the records. The copy is cheap, the data is shared until new records are added
+//
+
+ErrorRecords ErrorLog::records() const
+{
+    QMutexLocker Locker(&this->Mutex);
+    return this->Records;
+}
+
+//
+//  setLogFile
+//
+// Append the records of all the lists to a file, created if needed. An empty name closes the current file
+//
+
+void ErrorLog::setLogFile(const QString& filename)
+{
+    LogSink&     Sink = logSink();
+    QMutexLocker Locker(&Sink.Mutex);
+    Sink.File.close();
+    if (!filename.isEmpty()) {
+        Sink.File.setFileName(filename);
+        if (!Sink.File.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+            qWarning().noquote() << "Couldn't open the error log" << filename;
+        }
+        Sink.FlushTimer.start();
+    }
+}
+
+//
+//  flushLogFile
+//
+// Write the buffered records to the log file. Called at the end of a process, so the log is complete without waiting for the next record
+//
+
+void ErrorLog::flushLogFile()
+{
+    LogSink&     Sink = logSink();
+    QMutexLocker Locker(&Sink.Mutex);
+    if (Sink.File.isOpen()) {
+        Sink.File.flush();
+        Sink.FlushTimer.start();
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef ERRORLOG_HPP
+#define ERRORLOG_HPP
+
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+//
+//  ErrorRecords
+//
+// This class is a compact list of failed files. Each record holds the path of the file, the stage at which it failed
+// and the reason. Paths are packed into a single string pool, so a record costs a few bytes plus its path,
+// and copying the list is cheap: containers are implicitly shared until one of the copies is modified
+//
+
+class ErrorRecords
+{
+  public:
+    ErrorRecords();
+
+    // Processing stage at which a file failed
+    enum Stage : quint8 {
+        StageDrop,    // Probing of the dropped file
+        StageRead,    // Reading of the file to resize
+        StageProcess, // Decoding, resampling and encoding
+        StageWrite,   // Writing of the resized picture
+        StageQueue,   // The job couldn't be given to a worker
+    };
+
+    // Reason of a failure
+    enum Reason : quint8 {
+        ReasonNone,         // No failure
+        ReasonUnreadable,   // The file couldn't be opened or read, or its format is unknown
+        ReasonTooLarge,     // The picture exceeds the per-file size or memory limits
+        ReasonTimeout,      // Processing the file took longer than the per-file timeout
+        ReasonDecodeFailed, // The picture couldn't be decoded
+        ReasonEncodeFailed, // The resized picture couldn't be encoded
+        ReasonWriteFailed,  // The resized picture couldn't be written
+        ReasonCrashed,      // The worker process died while processing the file
+        ReasonNotProcessed, // No worker could process the file
+        ReasonCount,        // Number of reasons
+    };
+
+    int     count() const;                                               // Number of records
+    int     count(Reason reason) const;                                  // Number of records with a given reason
+    bool    isEmpty() const;                                             // Return true if there is no record
+    void    append(const QString& filename, Stage stage, Reason reason); // Add a record
+    void    clear();                                                     // Remove all the records
+    QString filename(int index) const;                                   // Path of the file of a record
+    Stage   stage(int index) const;                                      // Stage of a record
+    Reason  reason(int index) const;                                     // Reason of a record
+
+    static QString stageName(Stage stage);    // Name used in log files
+    static QString reasonName(Reason reason); // Name used in log files
+
+  private:
+    struct Record
+    {
+        quint32 Offset; // Offset of the path in NamePool
+        quint16 Length; // Length of the path
+        quint8  Stage;  // Stage value
+        quint8  Reason; // Reason value
+    };
+
+    QString         NamePool;     // All paths, concatenated
+    QVector<Record> Records;      // Records, in the order they were added
+    QVector<int>    ReasonCounts; // Number of records for each reason
+};
+
+//
+//  ErrorLog
+//
+// This class is a thread-safe list of failed files, filled by the worker threads and read by the UI.
+// When a log file is set, every record is also appended to it as soon as it's added, so the errors of a long batch
+// can be followed while it runs. The log file is shared by all the lists
+//
+
+class ErrorLog
+{
+  public:
+    void         append(const QString& filename, ErrorRecords::Stage stage, ErrorRecords::Reason reason); // Add a record, and write it to the log file
+    void         clear();                                                                                 // Remove all the records. The log file is not modified
+    bool         isEmpty() const;                                                                         // Return true if there is no record
+    ErrorRecords records() const;                                                                         // Copy of the records
+
+    static void setLogFile(const QString& filename); // Append the records to a file. An empty name stops logging
+    static void flushLogFile();                      // Write the buffered records to the log file
+
+  private:
+    ErrorRecords   Records; // Failed files
+    mutable QMutex Mutex;   // Control access to the records
+};
+
+//
+//  Interval between two flushes of the log file, in ms. Records are buffered in between
+//
+
+#define ERROR_LOG_FLUSH_INTERVAL 1000
+
+#endif // ERRORLOG_HPP
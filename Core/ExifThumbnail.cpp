@@ -0,0 +1,282 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "ExifThumbnail.hpp"
+#include <QBuffer>
+#include <QFile>
+#include <QImageReader>
+#include <QTransform>
+#include <cstring>
+
+//
+//  ExifThumbnail
+//
+// Constructors. An object built without data is invalid
+//
+
+ExifThumbnail::ExifThumbnail()
+    : Orientation(1)
+{
+}
+
+ExifThumbnail::ExifThumbnail(const QByteArray& data)
+    : Orientation(1)
+{
+    parse(data);
+}
+
+ExifThumbnail::ExifThumbnail(const QString& filename)
+    : Orientation(1)
+{
+    QFile File(filename);
+    if (File.open(QIODevice::ReadOnly)) {
+        parse(File.read(EXIF_HEAD_SIZE));
+    }
+}
+
+//
+//  isValid
+//
+// Return true if an embedded thumbnail has been found
+//
+
+bool ExifThumbnail::isValid() const
+{
+    return !this->Thumbnail.isEmpty();
+}
+
+//
+//  data
+//
+// Return the encoded embedded thumbnail
+//
+
+QByteArray ExifThumbnail::data() const
+{
+    return this->Thumbnail;
+}
+
+//
+//  orientation
+//
+// Return the EXIF orientation of the main picture
+//
+
+int ExifThumbnail::orientation() const
+{
+    return this->Orientation;
+}
+
+//
+//  size
+//
+// Return the size of the embedded thumbnail. Only its header is read
+//
+
+QSize ExifThumbnail::size() const
+{
+    if (!isValid()) {
+        return QSize();
+    }
+
+    QBuffer Buffer;
+    Buffer.setData(this->Thumbnail);
+    Buffer.open(QIODevice::ReadOnly);
+    QImageReader Reader(&Buffer, "jpeg");
+    return Reader.size();
+}
+
+//
+//  image
+//
+// Decode the embedded thumbnail
+//
+
+QImage ExifThumbnail::image() const
+{
+    return isValid() ? QImage::fromData(this->Thumbnail, "JPEG") : QImage();
+}
+
+//
+//  applyOrientation
+//
+// Return the picture as it must be displayed, according to its EXIF orientation
+//
+
+QImage ExifThumbnail::applyOrientation(const QImage& image, int orientation)
+{
+    switch (orientation) {
+        case 2:
+            return image.mirrored(true, false);
+        case 3:
+            return image.transformed(QTransform().rotate(180));
+        case 4:
+            return image.mirrored(false, true);
+        case 5:
+            return image.transformed(QTransform().rotate(90)).mirrored(true, false);
+        case 6:
+            return image.transformed(QTransform().rotate(90));
+        case 7:
+            return image.transformed(QTransform().rotate(270)).mirrored(true, false);
+        case 8:
+            return image.transformed(QTransform().rotate(270));
+        default:
+            return image;
+    }
+}
+
+//
+//  parse
+//
+// Walk through the JPEG segments until the EXIF APP1 segment is found, then parse its TIFF structure.
+// Parsing stops at the first scan, there is no metadata after it
+//
+
+void ExifThumbnail::parse(const QByteArray& data)
+{
+    const uchar* Data = reinterpret_cast<const uchar*>(data.constData());
+    int          Size = data.size();
+
+    // Check the SOI marker
+    if ((Size < 4) || (Data[0] != 0xFF) || (Data[1] != 0xD8)) {
+        return;
+    }
+
+    int Pos = 2;
+    while (Pos + 4 <= Size) {
+        if (Data[Pos] != 0xFF) {
+            return;
+        }
+
+        // Skip fill bytes
+        uchar Marker = Data[Pos + 1];
+        if (Marker == 0xFF) {
+            Pos++;
+            continue;
+        }
+
+        // Start of scan or end of image: no EXIF block
+        if ((Marker == 0xDA) || (Marker == 0xD9)) {
+            return;
+        }
+
+        int Length = (Data[Pos + 2] << 8) | Data[Pos + 3]; // Segment length, including the length field
+        if (Length < 2) {
+            return;
+        }
+
+        if ((Marker == 0xE1) && (Length >= 8) && (Pos + 10 <= Size) && (std::memcmp(Data + Pos + 4, "Exif\0\0", 6) == 0)) {
+            int TiffStart = Pos + 10;
+            int TiffSize  = qMin(Length - 8, Size - TiffStart);
+            parseTiff(data.constData() + TiffStart, TiffSize);
+            return;
+        }
+
+        Pos += 2 + Length;
+    }
+}
+
+//
+//  parseTiff
+//
+// Parse the TIFF structure of an EXIF block: orientation in IFD0, thumbnail location in IFD1.
+// Every access is bounds-checked, malformed files just don't provide a thumbnail
+//
+
+bool ExifThumbnail::parseTiff(const char* tiff, int size)
+{
+    const uchar* Data = reinterpret_cast<const uchar*>(tiff);
+    if (size < 8) {
+        return false;
+    }
+
+    // Byte order
+    bool LittleEndian;
+    if ((Data[0] == 'I') && (Data[1] == 'I')) {
+        LittleEndian = true;
+    }
+    else if ((Data[0] == 'M') && (Data[1] == 'M')) {
+        LittleEndian = false;
+    }
+    else {
+        return false;
+    }
+
+    bool Ok     = true;
+    auto Read16 = [&](qint64 pos) -> quint32 {
+        if ((pos < 0) || (pos + 2 > size)) {
+            Ok = false;
+            return 0;
+        }
+        return LittleEndian ? (Data[pos] | (Data[pos + 1] << 8)) : ((Data[pos] << 8) | Data[pos + 1]);
+    };
+    auto Read32 = [&](qint64 pos) -> quint32 {
+        if ((pos < 0) || (pos + 4 > size)) {
+            Ok = false;
+            return 0;
+        }
+        return LittleEndian ? (Read16(pos) | (Read16(pos + 2) << 16)) : ((Read16(pos) << 16) | Read16(pos + 2));
+    };
+
+    if (Read16(2) != 42) {
+        return false;
+    }
+
+    // IFD0: orientation
+    quint32 Ifd0  = Read32(4);
+    quint32 Count = Read16(Ifd0);
+    for (quint32 i = 0; Ok && (i < Count); i++) {
+        qint64 Entry = qint64(Ifd0) + 2 + i * 12;
+        if (Read16(Entry) == 0x0112) {
+            quint32 Value = Read16(Entry + 8);
+            if ((Value >= 1) && (Value <= 8)) {
+                this->Orientation = int(Value);
+            }
+        }
+    }
+
+    // IFD1: thumbnail offset and length
+    quint32 Ifd1 = Read32(qint64(Ifd0) + 2 + qint64(Count) * 12);
+    if (!Ok || (Ifd1 == 0)) {
+        return false;
+    }
+
+    quint32 Offset = 0;
+    quint32 Length = 0;
+    Count          = Read16(Ifd1);
+    for (quint32 i = 0; Ok && (i < Count); i++) {
+        qint64  Entry = qint64(Ifd1) + 2 + i * 12;
+        quint32 Tag   = Read16(Entry);
+        if (Tag == 0x0201) {
+            Offset = Read32(Entry + 8);
+        }
+        else if (Tag == 0x0202) {
+            Length = Read32(Entry + 8);
+        }
+    }
+
+    // Check that the thumbnail is a complete JPEG stream inside the block
+    if (!Ok || (Offset == 0) || (Length < 4) || (qint64(Offset) + Length > size) || (Data[Offset] != 0xFF) || (Data[Offset + 1] != 0xD8)) {
+        return false;
+    }
+
+    this->Thumbnail = QByteArray(tiff + Offset, int(Length));
+    return true;
+}
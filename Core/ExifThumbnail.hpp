@@ -0,0 +1,66 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef EXIFTHUMBNAIL_HPP
+#define EXIFTHUMBNAIL_HPP
+
+#include <QByteArray>
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+//
+//  ExifThumbnail
+//
+// This class extracts the preview embedded in the EXIF block of JPEG files (IFD1 JPEGInterchangeFormat),
+// and the orientation of the main picture. Only the head of the file is read
+//
+
+class ExifThumbnail
+{
+  public:
+    ExifThumbnail();
+    explicit ExifThumbnail(const QByteArray& data); // Parse the head of a JPEG file
+    explicit ExifThumbnail(const QString& filename); // Read and parse the head of a JPEG file
+
+    bool       isValid() const;     // True if an embedded thumbnail has been found
+    QByteArray data() const;        // Encoded (JPEG) embedded thumbnail
+    int        orientation() const; // EXIF orientation of the main picture (1 to 8, 1 if unknown)
+    QSize      size() const;        // Size of the embedded thumbnail, read from its header without decoding it
+    QImage     image() const;       // Decode the embedded thumbnail. Orientation is not applied
+
+    static QImage applyOrientation(const QImage& image, int orientation); // Rotate/mirror a picture according to an EXIF orientation
+
+  private:
+    void parse(const QByteArray& data);
+    bool parseTiff(const char* tiff, int size);
+
+    QByteArray Thumbnail;   // Embedded JPEG stream
+    int        Orientation; // Orientation tag of IFD0
+};
+
+//
+//  Number of bytes read at the beginning of a file to find the EXIF block.
+//  An APP1 segment is at most 64 KB, and it's almost always the first or second segment
+//
+
+#define EXIF_HEAD_SIZE (128 * 1024)
+
+#endif // EXIFTHUMBNAIL_HPP
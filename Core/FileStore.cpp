@@ -0,0 +1,350 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "FileStore.hpp"
+#include <algorithm>
+
+//
+//  FileStore
+//
+// Constructor
+//
+
+FileStore::FileStore()
+    : Released(0)
+{
+}
+
+//
+//  count
+//
+// Return the number of ids allocated by the store. Released ids are still counted
+//
+
+int FileStore::count() const
+{
+    return this->Flags.count();
+}
+
+//
+//  liveCount
+//
+// Return the number of files which are still present
+//
+
+int FileStore::liveCount() const
+{
+    return this->Flags.count() - this->Released;
+}
+
+//
+//  reserve
+//
+// Preallocate the columns, to avoid reallocations when a lot of files are added at once
+//
+
+void FileStore::reserve(int count)
+{
+    this->NameOffset.reserve(count);
+    this->NameLength.reserve(count);
+    this->DirectoryIds.reserve(count);
+    this->OrgSizes.reserve(count);
+    this->Flags.reserve(count);
+}
+
+//
+//  clear
+//
+// Remove all the files and release the memory
+//
+
+void FileStore::clear()
+{
+    this->Directories.clear();
+    this->DirectoryIndex.clear();
+    this->NamePool.clear();
+    this->NameOffset.clear();
+    this->NameLength.clear();
+    this->DirectoryIds.clear();
+    this->OrgSizes.clear();
+    this->Flags.clear();
+    this->PathHash.clear();
+    this->Released = 0;
+
+    // clear() keeps the capacity of some containers, force the memory release
+    this->NamePool.squeeze();
+    this->NameOffset.squeeze();
+    this->NameLength.squeeze();
+    this->DirectoryIds.squeeze();
+    this->OrgSizes.squeeze();
+    this->Flags.squeeze();
+}
+
+//
+//  append
+//
+// Add a file to the store. Return its id, or -1 if the file is already present
+//
+
+int FileStore::append(QString filename, QSize orgsize)
+{
+    // Split the path in directory + name. The directory keeps its trailing separator
+    int Separator = filename.lastIndexOf('/');
+    return append(internDirectory(filename.left(Separator + 1)), filename.constData() + Separator + 1, filename.size() - Separator - 1, orgsize);
+}
+
+//
+//  append
+//
+// Add a file whose directory has already been interned. The name is copied to the pool as is.
+// Return its id, or -1 if the file is already present
+//
+
+int FileStore::append(int directory, const QChar* name, int length, QSize orgsize)
+{
+    QString Filename = this->Directories.at(directory) + QString(name, length);
+    if (findFilename(Filename) != -1) {
+        return -1;
+    }
+
+    int Id = this->Flags.count();
+    this->NameOffset << quint32(this->NamePool.size());
+    this->NameLength << quint16(length);
+    this->NamePool.append(name, length);
+    this->DirectoryIds << quint32(directory);
+    this->OrgSizes << orgsize;
+    this->Flags << quint8(0);
+    this->PathHash.insert(hashFilename(Filename), quint32(Id));
+
+    return Id;
+}
+
+//
+//  addDirectory
+//
+// Intern a directory, with its trailing separator, so files can be added to it without splitting their path
+//
+
+int FileStore::addDirectory(const QString& directory)
+{
+    return internDirectory(directory);
+}
+
+//
+//  release
+//
+// Mark a file as removed. Its id stays allocated (ids never move), but the filename may be added again
+//
+
+void FileStore::release(int id)
+{
+    if ((this->Flags.at(id) & FlagReleased) == 0) {
+        this->Flags[id] |= FlagReleased;
+        this->PathHash.remove(hashFilename(filename(id)), quint32(id));
+        this->Released++;
+    }
+}
+
+//
+//  contains
+//
+// Return true if the filename is present in the store
+//
+
+bool FileStore::contains(QString filename) const
+{
+    return findFilename(filename) != -1;
+}
+
+//
+//  isReleased
+//
+// Return true if the file has been removed from the store
+//
+
+bool FileStore::isReleased(int id) const
+{
+    return (this->Flags.at(id) & FlagReleased) != 0;
+}
+
+//
+//  filename
+//
+// Rebuild the full path of a file
+//
+
+QString FileStore::filename(int id) const
+{
+    return this->Directories.at(this->DirectoryIds.at(id)) + this->NamePool.mid(this->NameOffset.at(id), this->NameLength.at(id));
+}
+
+//
+//  directory
+//
+// Return the parent directory of a file, with its trailing separator
+//
+
+QString FileStore::directory(int id) const
+{
+    return this->Directories.at(this->DirectoryIds.at(id));
+}
+
+//
+//  name
+//
+// Return the name of a file, without its directory
+//
+
+QString FileStore::name(int id) const
+{
+    return this->NamePool.mid(this->NameOffset.at(id), this->NameLength.at(id));
+}
+
+//
+//  directoryId
+//
+// Return the interned directory index of a file. Files sharing a directory share this index
+//
+
+int FileStore::directoryId(int id) const
+{
+    return this->DirectoryIds.at(id);
+}
+
+//
+//  compareFilenames
+//
+// Compare two paths, directory first then name, without building temporary strings.
+// Return a negative value if id1 comes first, 0 if they are equal, a positive value else
+//
+
+int FileStore::compareFilenames(int id1, int id2) const
+{
+    quint32 Dir1 = this->DirectoryIds.at(id1);
+    quint32 Dir2 = this->DirectoryIds.at(id2);
+    if (Dir1 != Dir2) {
+        return this->Directories.at(Dir1).compare(this->Directories.at(Dir2));
+    }
+
+    const QChar* Name1 = this->NamePool.constData() + this->NameOffset.at(id1);
+    const QChar* Name2 = this->NamePool.constData() + this->NameOffset.at(id2);
+    int          Size1 = this->NameLength.at(id1);
+    int          Size2 = this->NameLength.at(id2);
+    for (int i = 0; i < std::min(Size1, Size2); i++) {
+        if (Name1[i] != Name2[i]) {
+            return Name1[i].unicode() - Name2[i].unicode();
+        }
+    }
+    return Size1 - Size2;
+}
+
+//
+//  orgSize
+//
+// Return the original size of a picture
+//
+
+QSize FileStore::orgSize(int id) const
+{
+    return this->OrgSizes.at(id);
+}
+
+//
+//  orgPixels
+//
+// Return the pixel count of the original picture
+//
+
+qint64 FileStore::orgPixels(int id) const
+{
+    QSize Size = this->OrgSizes.at(id);
+    return qint64(Size.width()) * Size.height();
+}
+
+//
+//  jobStatus
+//
+// Return the status of the resizing job of a file
+//
+
+FileStore::JobStatus FileStore::jobStatus(int id) const
+{
+    return JobStatus((this->Flags.at(id) & FlagStatusMask) >> 1);
+}
+
+//
+//  setJobStatus
+//
+// Update the status of the resizing job of a file
+//
+
+void FileStore::setJobStatus(int id, JobStatus status)
+{
+    this->Flags[id] = quint8((this->Flags.at(id) & ~FlagStatusMask) | ((status << 1) & FlagStatusMask));
+}
+
+//
+//  internDirectory
+//
+// Return the index of a directory in the interned list. Add it if it's not known yet
+//
+
+int FileStore::internDirectory(const QString& directory)
+{
+    auto Iterator = this->DirectoryIndex.constFind(directory);
+    if (Iterator != this->DirectoryIndex.constEnd()) {
+        return Iterator.value();
+    }
+
+    int Index = this->Directories.count();
+    this->Directories << directory;
+    this->DirectoryIndex.insert(directory, quint32(Index));
+    return Index;
+}
+
+//
+//  findFilename
+//
+// Return the id of a live file, or -1 if the filename is not in the store
+//
+
+int FileStore::findFilename(const QString& filename) const
+{
+    uint Hash     = hashFilename(filename);
+    auto Iterator = this->PathHash.constFind(Hash);
+    while ((Iterator != this->PathHash.constEnd()) && (Iterator.key() == Hash)) {
+        if (this->filename(Iterator.value()) == filename) {
+            return Iterator.value();
+        }
+        ++Iterator;
+    }
+    return -1;
+}
+
+//
+//  hashFilename
+//
+// Hash a full path. Only the hash is stored, the path is compared on collision
+//
+
+uint FileStore::hashFilename(const QString& filename) const
+{
+    return uint(qHash(filename));
+}
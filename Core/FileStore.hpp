@@ -0,0 +1,98 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef FILESTORE_HPP
+#define FILESTORE_HPP
+
+#include <QHash>
+#include <QMultiHash>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+//
+//  FileStore
+//
+// This class is a compact columnar storage for the dropped files.
+// Each file is identified by an id (its index in the store), which never changes until the store is cleared.
+// Parent directories are interned, file names are packed into a single string pool,
+// so a row costs a few tens of bytes instead of several heap-allocated objects.
+// New sizes are not stored: they are computed on demand from the ResizeParameters.
+//
+
+class FileStore
+{
+  public:
+    FileStore();
+
+    // Per-file flags
+    enum Flag : quint8 {
+        FlagReleased   = 0x01, // The file has been removed from the list, its id is dead
+        FlagStatusMask = 0x0E, // Bits holding the JobStatus of the file
+    };
+
+    // Status of the resizing job of a file. The job id is the file id
+    enum JobStatus : quint8 {
+        StatusNone    = 0, // File is not part of a resizing process
+        StatusQueued  = 1, // Waiting for a worker
+        StatusRunning = 2, // Being resized
+        StatusDone    = 3, // Successfully resized
+        StatusFailed  = 4, // Couldn't be resized
+    };
+
+    int       count() const;                                                       // Number of ids allocated in the store (released ones included)
+    int       liveCount() const;                                                   // Number of files which have not been released
+    void      reserve(int count);                                                  // Preallocate storage for the given file count
+    void      clear();                                                             // Remove everything
+    int       append(QString filename, QSize orgsize);                             // Add a file. Return its id, or -1 if the file is already present
+    int       append(int directory, const QChar* name, int length, QSize orgsize); // Add a file of an interned directory. Return its id, or -1 if the file is already present
+    int       addDirectory(const QString& directory);                              // Intern a directory, with its trailing separator. Return its index
+    void      release(int id);                                                     // Mark a file as removed. Its filename may be added again
+    bool      contains(QString filename) const;                                    // Return true if the filename is present and not released
+    bool      isReleased(int id) const;                                            // Return true if the file has been removed
+    QString   filename(int id) const;                                              // Full path of a file
+    QString   directory(int id) const;                                             // Parent directory of a file, with a trailing separator
+    QString   name(int id) const;                                                  // Name of a file, without its directory
+    int       directoryId(int id) const;                                           // Interned directory index, suitable for fast grouping
+    int       compareFilenames(int id1, int id2) const;                            // Compare two full paths without building them (<0, 0, >0)
+    QSize     orgSize(int id) const;                                               // Original size of the picture
+    qint64    orgPixels(int id) const;                                             // Pixel count of the original picture, used as a numeric sort key
+    JobStatus jobStatus(int id) const;                                             // Status of the resizing job of a file
+    void      setJobStatus(int id, JobStatus status);                              // Update the status of the resizing job of a file
+
+  private:
+    int  internDirectory(const QString& directory);   // Return the index of a directory, adding it if needed
+    int  findFilename(const QString& filename) const; // Return the live id of a filename, or -1
+    uint hashFilename(const QString& filename) const; // Hash used for duplicate detection
+
+    QStringList               Directories;    // Interned parent directories, with trailing separator
+    QHash<QString, quint32>   DirectoryIndex; // Directory -> index in Directories
+    QString                   NamePool;       // All file names (without directory), concatenated
+    QVector<quint32>          NameOffset;     // Offset of each name in NamePool
+    QVector<quint16>          NameLength;     // Length of each name
+    QVector<quint32>          DirectoryIds;   // Index of the parent directory of each file
+    QVector<QSize>            OrgSizes;       // Original picture sizes
+    QVector<quint8>           Flags;          // Combination of Flag values
+    QMultiHash<uint, quint32> PathHash;       // Hash of full path -> id, for O(1) duplicate detection
+    int                       Released;       // Number of released ids
+};
+
+#endif // FILESTORE_HPP
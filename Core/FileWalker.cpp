@@ -0,0 +1,43 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "FileWalker.hpp"
+#include "ImageFormats.hpp"
+#include <QDir>
+#include <QDirIterator>
+
+//
+//  getFiles
+//
+// Append the files contained in a directory and its subdirectories. Hidden files are skipped.
+// The UI keeps every file, so the ones which are not pictures are reported as invalid. The command line mode filters them
+// by extension, so a hot folder may contain other files without failing the batch
+//
+
+void FileWalker::getFiles(QStringList& list, const QString& directory, bool readableonly)
+{
+    QDirIterator Iterator(directory, QDir::Files, QDirIterator::Subdirectories);
+    while (Iterator.hasNext()) {
+        QString Filename = Iterator.next();
+        if (!readableonly || ImageFormats::isReadable(Filename)) {
+            list << Filename;
+        }
+    }
+}
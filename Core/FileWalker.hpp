@@ -18,16 +18,24 @@
  * mail: martial <dot> demolins <at> gmail <dot> com
  */
 
-#include "TableItem.hpp"
+#ifndef FILEWALKER_HPP
+#define FILEWALKER_HPP
+
+#include <QString>
+#include <QStringList>
 
 //
-//  TableItem
+//  FileWalker
 //
-// Create a QTableWidgetItem with a centered content
+// This class lists the files of dropped directories, for the UI and the command line mode.
+// Directories are walked with an iterator: entries are streamed from the file system, without building and sorting
+// a list of every directory, and without recursion, so deep trees with millions of files are walked in linear time
 //
 
-TableItem::TableItem(QString text)
-    : QTableWidgetItem(text, Qt::DisplayRole)
+class FileWalker
 {
-    setTextAlignment(Qt::AlignCenter);
-}
+  public:
+    static void getFiles(QStringList& list, const QString& directory, bool readableonly); // Append the files of a directory and its subdirectories. If readableonly is true, only the pictures are kept
+};
+
+#endif // FILEWALKER_HPP
@@ -0,0 +1,110 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "ImageFormats.hpp"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QSettings>
+#include <QStringList>
+
+//
+//  readable
+//
+// Return the readable formats, in lowercase. The list is built on first use only, and is thread-safe
+//
+
+const QList<QByteArray>& ImageFormats::readable()
+{
+    static const QList<QByteArray> Formats = load();
+    return Formats;
+}
+
+//
+//  isReadable
+//
+// Return true if the extension of a file is a readable format. The file itself is not opened
+//
+
+bool ImageFormats::isReadable(const QString& filename)
+{
+    return readable().contains(QFileInfo(filename).suffix().toLower().toLatin1());
+}
+
+//
+//  load
+//
+// Read the list persisted by a previous session. If the plugins have changed since, ask Qt, which loads every plugin,
+// and persist the new list
+//
+
+QList<QByteArray> ImageFormats::load()
+{
+    QSettings         Settings;
+    QString           Signature = signature();
+    QList<QByteArray> Formats;
+    if (Settings.value("ImageFormats/Signature").toString() == Signature) {
+        for (const QString& Format : Settings.value("ImageFormats/Readable").toStringList()) {
+            Formats << Format.toLatin1();
+        }
+        if (!Formats.isEmpty()) {
+            return Formats;
+        }
+    }
+
+    QStringList Names;
+    for (const QByteArray& Format : QImageReader::supportedImageFormats()) {
+        QByteArray Lower = Format.toLower();
+        if (!Formats.contains(Lower)) {
+            Formats << Lower;
+            Names << QString::fromLatin1(Lower);
+        }
+    }
+    Settings.setValue("ImageFormats/Signature", Signature);
+    Settings.setValue("ImageFormats/Readable", Names);
+    return Formats;
+}
+
+//
+//  signature
+//
+// Fingerprint of the image plugins: Qt version, name, size and date of the files found in the imageformats directories,
+// and date of the executable, which contains the static plugins. Listing directories doesn't load anything
+//
+
+QString ImageFormats::signature()
+{
+    QCryptographicHash Hash(QCryptographicHash::Sha1);
+    Hash.addData(QByteArray(qVersion()));
+    Hash.addData(QByteArray::number(QFileInfo(QCoreApplication::applicationFilePath()).lastModified().toMSecsSinceEpoch()));
+
+    for (const QString& Path : QCoreApplication::libraryPaths()) {
+        QDir Directory(Path + "/imageformats");
+        for (const QFileInfo& Plugin : Directory.entryInfoList(QDir::Files, QDir::Name)) {
+            Hash.addData(Plugin.fileName().toUtf8());
+            Hash.addData(QByteArray::number(Plugin.size()));
+            Hash.addData(QByteArray::number(Plugin.lastModified().toMSecsSinceEpoch()));
+        }
+    }
+    return QString::fromLatin1(Hash.result().toHex());
+}
@@ -0,0 +1,49 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef IMAGEFORMATS_HPP
+#define IMAGEFORMATS_HPP
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+//
+//  ImageFormats
+//
+// This class gives the list of the readable picture formats without loading the image plugins.
+// QImageReader::supportedImageFormats() loads and initializes every plugin, which costs a noticeable part of the startup time.
+// The list is built once, then persisted in the settings with a signature of the installed plugins (Qt version,
+// plugin files and their dates, executable date for static plugins). It's built again only when the signature changes.
+// Nothing is loaded before the list is needed: decoding a file only loads the plugin of its format
+//
+
+class ImageFormats
+{
+  public:
+    static const QList<QByteArray>& readable();                          // Lowercase readable formats. Built or read from the settings on first use
+    static bool                     isReadable(const QString& filename); // Return true if the extension of a file is a readable format
+
+  private:
+    static QList<QByteArray> load();      // Read the persisted list, or build it and persist it if the plugins have changed
+    static QString           signature(); // Fingerprint of the installed image plugins
+};
+
+#endif // IMAGEFORMATS_HPP
@@ -0,0 +1,144 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "ImageLimits.hpp"
+#include <QSettings>
+
+//
+//  ImageLimits
+//
+// Constructor. Default limits are far above what cameras and scanners produce
+//
+
+ImageLimits::ImageLimits()
+    : MaxPixels(qint64(DEFAULT_MAX_MEGAPIXELS) * 1000 * 1000)
+    , AllocationLimit(DEFAULT_ALLOCATION_LIMIT)
+    , Timeout(DEFAULT_FILE_TIMEOUT)
+{
+}
+
+//
+//  fromSettings
+//
+// Read the per-file limits, checked when files are dropped and when they are resized
+//
+
+ImageLimits ImageLimits::fromSettings()
+{
+    QSettings   Settings;
+    ImageLimits Limits;
+    Limits.MaxPixels       = qMax(Settings.value("Limits/MaxMegapixels", DEFAULT_MAX_MEGAPIXELS).toLongLong(), qint64(0)) * 1000 * 1000;
+    Limits.AllocationLimit = qMax(Settings.value("Limits/AllocationLimit", Limits.AllocationLimit).toInt(), 0);
+    Limits.Timeout         = qMax(Settings.value("Limits/Timeout", Limits.Timeout).toInt(), 0);
+    return Limits;
+}
+
+//
+//  accepts
+//
+// Return true if a picture of this size may be processed. Unknown sizes are accepted: the decoder will tell
+//
+
+bool ImageLimits::accepts(QSize size) const
+{
+    if (!size.isValid() || (this->MaxPixels <= 0)) {
+        return true;
+    }
+    return qint64(size.width()) * size.height() <= this->MaxPixels;
+}
+
+//
+//  apply
+//
+// Set the allocation limit of a reader. Qt 5 readers have no such limit, only the dimension check protects them
+//
+
+void ImageLimits::apply(QImageReader& reader) const
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    reader.setAllocationLimit(qMax(this->AllocationLimit, 0));
+#else
+    Q_UNUSED(reader)
+#endif
+}
+
+//
+//  isTimedOut
+//
+// Return true if the time spent on a file exceeds the timeout
+//
+
+bool ImageLimits::isTimedOut(qint64 elapsedns) const
+{
+    return (this->Timeout > 0) && (elapsedns > qint64(this->Timeout) * 1000 * 1000 * 1000);
+}
+
+//
+//  deadline
+//
+// Return the deadline of a file which has already been processed for elapsedns. Never expires if there is no timeout
+//
+
+QDeadlineTimer ImageLimits::deadline(qint64 elapsedns) const
+{
+    if (this->Timeout <= 0) {
+        return QDeadlineTimer(QDeadlineTimer::Forever);
+    }
+    return QDeadlineTimer(qMax(qint64(this->Timeout) * 1000 - elapsedns / (1000 * 1000), qint64(0)));
+}
+
+//
+//  DeadlineBuffer
+//
+// Constructor. The buffer reads data, it must be opened by the caller or by the reader
+//
+
+DeadlineBuffer::DeadlineBuffer(QByteArray* data, QDeadlineTimer deadline)
+    : QBuffer(data)
+    , Deadline(deadline)
+    , Expired(false)
+{
+}
+
+//
+//  hasExpired
+//
+// Return true if a read has been refused. The data given to the decoder was then truncated, its result must be discarded
+//
+
+bool DeadlineBuffer::hasExpired() const
+{
+    return this->Expired;
+}
+
+//
+//  readData
+//
+// Read from the buffer, unless the deadline has passed. Decoders read by small chunks, so checking the clock here is cheap
+//
+
+qint64 DeadlineBuffer::readData(char* data, qint64 maxsize)
+{
+    if (this->Deadline.hasExpired()) {
+        this->Expired = true;
+        return -1;
+    }
+    return QBuffer::readData(data, maxsize);
+}
@@ -0,0 +1,83 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef IMAGELIMITS_HPP
+#define IMAGELIMITS_HPP
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QDeadlineTimer>
+#include <QImageReader>
+#include <QSize>
+
+//
+//  ImageLimits
+//
+// Per-file limits protecting the program from decompression bombs: a tiny PNG can announce 60000 x 60000 pixels,
+// and make a worker allocate gigabytes and decode for minutes. Dimensions are checked from the header before decoding,
+// both when files are dropped and before they are resized. Files violating a limit are reported apart from invalid files
+//
+
+struct ImageLimits
+{
+    ImageLimits();
+    static ImageLimits fromSettings(); // Read the limits from the settings. Missing or invalid values are replaced by the default ones
+
+    qint64 MaxPixels;       // Largest picture accepted, in pixels. 0 means no limit
+    int    AllocationLimit; // Largest buffer an image plugin may allocate, in MB. Only enforced by Qt 6. 0 means no limit
+    int    Timeout;         // Longest time spent on a file, in seconds. 0 means no limit
+
+    bool           accepts(QSize size) const;          // Return true if a picture of this size may be processed
+    void           apply(QImageReader& reader) const;  // Set the allocation limit of a reader
+    bool           isTimedOut(qint64 elapsedns) const; // Return true if the time spent on a file exceeds the timeout
+    QDeadlineTimer deadline(qint64 elapsedns) const;   // Deadline of a file which has already been processed for some time
+};
+
+//
+//  DeadlineBuffer
+//
+// This class is a buffer whose reads fail once a deadline has passed. Decoders read their input while they decode,
+// so a decoder fed by this buffer stops at its next read when the per-file timeout is exceeded, instead of holding
+// its worker until the end. Decoders which read their whole input before decoding can't be stopped this way
+//
+
+class DeadlineBuffer: public QBuffer
+{
+  public:
+    DeadlineBuffer(QByteArray* data, QDeadlineTimer deadline);
+    bool hasExpired() const; // Return true if a read has been refused because of the deadline
+
+  protected:
+    qint64 readData(char* data, qint64 maxsize) override; // Read from the buffer, or fail if the deadline has passed
+
+  private:
+    QDeadlineTimer Deadline; // Time after which reads fail
+    bool           Expired;  // A read has been refused
+};
+
+//
+//  Default limits: 250 Mpx (1 GB in 32 bits), 1 GB per allocation, two minutes per file
+//
+
+#define DEFAULT_MAX_MEGAPIXELS 250
+#define DEFAULT_ALLOCATION_LIMIT 1024
+#define DEFAULT_FILE_TIMEOUT 120
+
+#endif // IMAGELIMITS_HPP
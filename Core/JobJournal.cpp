@@ -0,0 +1,318 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "JobJournal.hpp"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QUrl>
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+//
+//  JobJournal
+//
+// Constructor. The journal is opened when the first jobs are planned, so the previous one can be read before
+//
+
+JobJournal::JobJournal()
+    : Sequence(0)
+    , Failed(false)
+{
+}
+
+//
+//  instance
+//
+// Return the journal shared by the program
+//
+
+JobJournal* JobJournal::instance()
+{
+    static JobJournal Instance;
+    return &Instance;
+}
+
+//
+//  filename
+//
+// Journal file, in the application data directory. Empty if there is no such directory
+//
+
+QString JobJournal::filename()
+{
+    QString Directory = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    return Directory.isEmpty() ? QString() : Directory + "/journal.txt";
+}
+
+//
+//  isEnabled
+//
+// Return true if journaling is enabled in the settings
+//
+
+bool JobJournal::isEnabled()
+{
+    return QSettings().value("Resize/Journal", true).toBool();
+}
+
+//
+//  plan
+//
+// Record jobs about to be resized, and sync them, so they can be resumed whatever happens next.
+// Called once per batch of jobs, not per file. The files are examined before locking the journal, so the workers
+// completing jobs don't wait for the disk. A job planned again gets a new key, and its previous plan is marked as handled
+//
+
+void JobJournal::plan(const QList<ResizeJob>& jobs)
+{
+    if (jobs.isEmpty()) {
+        return;
+    }
+
+    QList<QByteArray> Records;
+    for (const ResizeJob& Job : jobs) {
+        QFileInfo         Info(Job.Filename);
+        QList<QByteArray> Fields;
+        Fields << QByteArray::number(Info.size()) << QByteArray::number(Info.lastModified().toMSecsSinceEpoch());
+        Fields << QByteArray::number(Job.OrgSize.width()) << QByteArray::number(Job.OrgSize.height());
+        Fields << QByteArray::number(Job.NewSize.width()) << QByteArray::number(Job.NewSize.height());
+        Fields << QUrl::toPercentEncoding(Job.Filename);
+        Records << Fields.join('\t') + '\n';
+    }
+
+    QMutexLocker Locker(&this->Mutex);
+    if (!this->File.isOpen() && !open()) {
+        return;
+    }
+
+    for (int i = 0; i < jobs.count(); i++) {
+        quint64 Key = ++this->Sequence;
+        if (this->Keys.contains(jobs.at(i).Id)) {
+            quint64 Previous = this->Keys.value(jobs.at(i).Id);
+            this->Pending.remove(Previous);
+            this->Buffer += "D\t" + QByteArray::number(Previous) + '\n';
+        }
+        this->Keys[jobs.at(i).Id] = Key;
+        this->Pending.insert(Key);
+        this->Buffer += "J\t" + QByteArray::number(Key) + '\t' + Records.at(i);
+    }
+    write(true);
+}
+
+//
+//  complete
+//
+// Record a handled job. Records are written by blocks of JOURNAL_BUFFER_SIZE bytes, and synced at most every JOURNAL_SYNC_INTERVAL ms
+//
+
+void JobJournal::complete(int id)
+{
+    QMutexLocker Locker(&this->Mutex);
+    if (!this->File.isOpen() || !this->Keys.contains(id)) {
+        return;
+    }
+
+    quint64 Key = this->Keys.take(id);
+    this->Pending.remove(Key);
+    this->Buffer += "D\t" + QByteArray::number(Key) + '\n';
+    bool Sync = this->SyncTimer.hasExpired(JOURNAL_SYNC_INTERVAL);
+    if (Sync || (this->Buffer.size() >= JOURNAL_BUFFER_SIZE)) {
+        write(Sync);
+    }
+}
+
+//
+//  finish
+//
+// A resizing process ended. Sync the journal. If every planned job has been handled, there is nothing to resume: empty it
+//
+
+void JobJournal::finish()
+{
+    QMutexLocker Locker(&this->Mutex);
+    if (!this->File.isOpen()) {
+        return;
+    }
+
+    if (this->Pending.isEmpty()) {
+        this->Buffer.clear();
+        this->File.resize(0);
+        this->File.seek(0);
+    }
+    write(true);
+}
+
+//
+//  unfinishedJobs
+//
+// Read the jobs left unfinished by the previous run. Jobs whose file doesn't exist anymore, or whose size or modification
+// time changed since the job was planned, are skipped: the file has been written and its completion was not synced yet.
+// The jobs are given sequential ids. Return nothing once this run has planned jobs, or if another instance uses the journal
+//
+
+QList<ResizeJob> JobJournal::unfinishedJobs()
+{
+    QMutexLocker Locker(&this->Mutex);
+
+    QList<ResizeJob> Jobs;
+    QFile            Journal(filename());
+    if (this->File.isOpen() || !lock() || !Journal.open(QIODevice::ReadOnly)) {
+        return Jobs;
+    }
+
+    // A truncated or malformed line, written during a crash, is ignored
+    QHash<quint64, int> Index;    // Key -> position in Jobs
+    QList<qint64>       Sizes;    // Size of each file when its job was planned
+    QList<qint64>       Modified; // Modification time of each file when its job was planned
+    QList<bool>         Handled;  // True if the job has been handled
+    for (QByteArray Line = Journal.readLine(); !Line.isEmpty(); Line = Journal.readLine()) {
+        QList<QByteArray> Fields = Line.trimmed().split('\t');
+        bool              Ok[8];
+        if ((Fields.count() == 9) && (Fields.at(0) == "J")) {
+            ResizeJob Job;
+            quint64   Key  = Fields.at(1).toULongLong(&Ok[0]);
+            qint64    Size = Fields.at(2).toLongLong(&Ok[1]);
+            qint64    Time = Fields.at(3).toLongLong(&Ok[2]);
+            Job.OrgSize    = QSize(Fields.at(4).toInt(&Ok[3]), Fields.at(5).toInt(&Ok[4]));
+            Job.NewSize    = QSize(Fields.at(6).toInt(&Ok[5]), Fields.at(7).toInt(&Ok[6]));
+            Job.Filename   = QUrl::fromPercentEncoding(Fields.at(8));
+            Ok[7]          = !Job.Filename.isEmpty();
+            if (Ok[0] && Ok[1] && Ok[2] && Ok[3] && Ok[4] && Ok[5] && Ok[6] && Ok[7]) {
+                Index[Key] = Jobs.count();
+                Jobs << Job;
+                Sizes << Size;
+                Modified << Time;
+                Handled << false;
+            }
+        }
+        else if ((Fields.count() == 2) && (Fields.at(0) == "D")) {
+            quint64 Key = Fields.at(1).toULongLong(&Ok[0]);
+            if (Ok[0] && Index.contains(Key)) {
+                Handled[Index.value(Key)] = true;
+            }
+        }
+    }
+
+    QList<ResizeJob> Unfinished;
+    for (int i = 0; i < Jobs.count(); i++) {
+        QFileInfo Info(Jobs.at(i).Filename);
+        if (!Handled.at(i) && Info.exists() && (Info.size() == Sizes.at(i)) && (Info.lastModified().toMSecsSinceEpoch() == Modified.at(i))) {
+            Unfinished << Jobs.at(i);
+            Unfinished.last().Id = Unfinished.count() - 1;
+        }
+    }
+    return Unfinished;
+}
+
+//
+//  discard
+//
+// Forget the jobs of the previous run: the journal is emptied now instead of when the first jobs are planned
+//
+
+void JobJournal::discard()
+{
+    QMutexLocker Locker(&this->Mutex);
+    if (!this->File.isOpen()) {
+        open();
+    }
+}
+
+//
+//  lock
+//
+// Take the lock of the journal. It's kept until the program exits, so two instances don't mix their jobs.
+// The lock of a crashed instance is stale, it's taken over
+//
+
+bool JobJournal::lock()
+{
+    if (!this->Lock.isNull()) {
+        return true;
+    }
+
+    QString Filename = filename();
+    if (Filename.isEmpty() || !QDir().mkpath(QFileInfo(Filename).absolutePath())) {
+        return false;
+    }
+    this->Lock.reset(new QLockFile(Filename + ".lock"));
+    if (!this->Lock->tryLock(0)) {
+        this->Lock.reset();
+        return false;
+    }
+    return true;
+}
+
+//
+//  open
+//
+// Lock and open the journal, emptying it: the jobs of the previous run have been resumed or discarded.
+// If it fails, journaling is disabled for the whole run, with a single warning
+//
+
+bool JobJournal::open()
+{
+    if (this->Failed) {
+        return false;
+    }
+
+    this->File.setFileName(filename());
+    if (!isEnabled() || !lock() || !this->File.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (isEnabled()) {
+            qWarning().noquote() << "Couldn't open the job journal, jobs won't be resumable:" << this->File.fileName();
+        }
+        this->Failed = true;
+        return false;
+    }
+    this->SyncTimer.start();
+    return true;
+}
+
+//
+//  write
+//
+// Write the buffered records. If sync is true, wait until they are on the disk
+//
+
+void JobJournal::write(bool sync)
+{
+    if (!this->Buffer.isEmpty()) {
+        this->File.write(this->Buffer);
+        this->Buffer.clear();
+    }
+    this->File.flush();
+
+    if (sync) {
+#ifdef Q_OS_WIN
+        _commit(this->File.handle());
+#else
+        fsync(this->File.handle());
+#endif
+        this->SyncTimer.start();
+    }
+}
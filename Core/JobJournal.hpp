@@ -0,0 +1,94 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef JOBJOURNAL_HPP
+#define JOBJOURNAL_HPP
+
+#include "ResizeJob.hpp"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QLockFile>
+#include <QMutex>
+#include <QScopedPointer>
+#include <QSet>
+#include <QString>
+
+//
+//  JobJournal
+//
+// This class keeps an append-only journal of the resizing jobs, so the jobs left unfinished by an interruption, a crash
+// or a reboot can be resumed without dropping and probing the files again. Used by the resize thread, in the GUI and in batch mode.
+//
+// Format (tab-separated, one record per line):
+//   J <key> <bytes> <mtime> <orgw> <orgh> <neww> <newh> <path>   a planned job: size and modification time (ms since epoch)
+//                                                                of the file when it was planned, its sizes and its path
+//   D <key>                                                      the job has been handled, successfully or not
+// Keys are numbered per run, as job ids are reused by the file store once it's cleared.
+// Planned jobs are synced to disk before they start. Completions are buffered and synced at most every JOURNAL_SYNC_INTERVAL ms,
+// so the journal costs a few bytes per file. A completion lost in a crash is recovered when resuming: a file whose size
+// or modification time changed since its job was planned has already been written, and is not resized twice.
+// Timestamps are compared for equality, so coarse (FAT) or skewed (network shares) clocks don't matter.
+// The journal is emptied when a resizing process ends with no unfinished job. It's locked, so only one PicRes instance uses it
+//
+
+class JobJournal
+{
+  public:
+    static JobJournal* instance();                         // Return the journal shared by the program
+    static QString     filename();                         // Journal file, in the application data directory
+    void               plan(const QList<ResizeJob>& jobs); // Record jobs about to be resized. Synced before returning
+    void               complete(int id);                   // Record a handled job. Synced by batches
+    void               finish();                           // A resizing process ended: sync, and empty the journal if no job is unfinished
+    QList<ResizeJob>   unfinishedJobs();                   // Jobs of the previous run which were not handled, read from the journal
+    void               discard();                          // Forget the jobs of the previous run
+    static bool        isEnabled();                        // Return true if journaling is enabled in the settings
+
+  private:
+    JobJournal();
+    bool lock();           // Take the lock of the journal, once for the whole run. Return false if another instance holds it
+    bool open();           // Lock and open the journal, emptying it. Return false if it can't be used
+    void write(bool sync); // Write the buffered records, and sync them to disk if requested
+
+    QMutex                    Mutex;     // Protect the state below, shared by the workers
+    QScopedPointer<QLockFile> Lock;      // Lock held while this instance uses the journal
+    QFile                     File;      // Journal, open once the first jobs of this run are planned
+    QByteArray                Buffer;    // Records not written yet
+    QHash<int, quint64>       Keys;      // Job id -> key of its last plan
+    QSet<quint64>             Pending;   // Keys of the planned jobs which have not been handled yet
+    quint64                   Sequence;  // Last key given to a job
+    QElapsedTimer             SyncTimer; // Time since the last sync
+    bool                      Failed;    // True if the journal couldn't be opened: journaling is disabled until the program restarts
+};
+
+//
+//  Maximum time between two syncs of the completed jobs, in ms
+//
+
+#define JOURNAL_SYNC_INTERVAL 1000
+
+//
+//  Size of the buffer of completed jobs written at once, in bytes
+//
+
+#define JOURNAL_BUFFER_SIZE (64 * 1024)
+
+#endif // JOBJOURNAL_HPP
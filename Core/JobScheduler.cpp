@@ -0,0 +1,367 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "JobScheduler.hpp"
+#include <QFile>
+#include <QHash>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+//
+//  JobScheduler
+//
+// Constructor. nsperpixel is the cost coefficient used for the predictions, usually the one measured during the previous run
+//
+
+JobScheduler::JobScheduler(Policy policy, int workers, double nsperpixel)
+    : Scheduling(policy)
+    , Workers(qMax(workers, 1))
+    , NsPerPixel(nsperpixel > 0.0 ? nsperpixel : DEFAULT_NS_PER_PIXEL)
+    , Elapsed(0)
+{
+}
+
+//
+//  reset
+//
+// Forget the jobs of the previous run, and set the parameters of the next one
+//
+
+void JobScheduler::reset(Policy policy, int workers, double nsperpixel)
+{
+    QMutexLocker Locker(&this->Mutex);
+    this->Scheduling = policy;
+    this->Workers    = qMax(workers, 1);
+    this->NsPerPixel = nsperpixel > 0.0 ? nsperpixel : DEFAULT_NS_PER_PIXEL;
+    this->Elapsed    = 0;
+    this->Jobs.clear();
+    this->Starts.clear();
+    this->Durations.clear();
+}
+
+//
+//  cost
+//
+// Estimated cost of a job. Decoding is proportional to the original pixel count, resampling and encoding to the new one
+//
+
+double JobScheduler::cost(const ResizeJob& job)
+{
+    return double(job.OrgSize.width()) * job.OrgSize.height() + double(job.NewSize.width()) * job.NewSize.height();
+}
+
+//
+//  order
+//
+// Order the jobs according to the policy. Sorts are stable, so jobs of equal cost keep the order of the table
+//
+
+QList<ResizeJob> JobScheduler::order(const QList<ResizeJob>& jobs) const
+{
+    QVector<int>    Indexes(jobs.count());
+    QVector<double> Costs(jobs.count());
+    for (int i = 0; i < jobs.count(); i++) {
+        Indexes[i] = i;
+        Costs[i]   = cost(jobs.at(i));
+    }
+
+    if (this->Scheduling == PolicyLargestFirst) {
+        std::stable_sort(Indexes.begin(), Indexes.end(), [&Costs](int a, int b) { return Costs.at(a) > Costs.at(b); });
+    }
+    else if (this->Scheduling == PolicyDirectoryLargestFirst) {
+        // Compute the total cost of each directory
+        QHash<QString, int> GroupIndex;
+        QVector<int>        Groups(jobs.count());
+        QVector<double>     GroupCosts;
+        for (int i = 0; i < jobs.count(); i++) {
+            const QString& Filename  = jobs.at(i).Filename;
+            QString        Directory = Filename.left(Filename.lastIndexOf('/'));
+            int            Group     = GroupIndex.value(Directory, -1);
+            if (Group == -1) {
+                Group = GroupCosts.count();
+                GroupIndex.insert(Directory, Group);
+                GroupCosts << 0.0;
+            }
+            Groups[i] = Group;
+            GroupCosts[Group] += Costs.at(i);
+        }
+
+        // Costliest directories first, then costliest files first inside a directory
+        std::stable_sort(Indexes.begin(), Indexes.end(), [&](int a, int b) {
+            int GroupA = Groups.at(a);
+            int GroupB = Groups.at(b);
+            if (GroupA != GroupB) {
+                if (GroupCosts.at(GroupA) != GroupCosts.at(GroupB)) {
+                    return GroupCosts.at(GroupA) > GroupCosts.at(GroupB);
+                }
+                return GroupA < GroupB;
+            }
+            return Costs.at(a) > Costs.at(b);
+        });
+    }
+
+    QList<ResizeJob> Ordered;
+    Ordered.reserve(jobs.count());
+    for (int Index : Indexes) {
+        Ordered << jobs.at(Index);
+    }
+    return Ordered;
+}
+
+//
+//  append
+//
+// Order a batch of jobs, and append it to the run. Timings of the new jobs are unknown until they are recorded
+//
+
+void JobScheduler::append(const QList<ResizeJob>& jobs)
+{
+    QList<ResizeJob> Ordered = order(jobs);
+
+    QMutexLocker Locker(&this->Mutex);
+    this->Jobs << Ordered;
+    this->Starts.resize(this->Jobs.count());
+    this->Durations.resize(this->Jobs.count());
+    for (int i = this->Jobs.count() - Ordered.count(); i < this->Jobs.count(); i++) {
+        this->Starts[i]    = 0;
+        this->Durations[i] = -1;
+    }
+}
+
+//
+//  count
+//
+// Return the number of jobs of the run
+//
+
+int JobScheduler::count() const
+{
+    QMutexLocker Locker(&this->Mutex);
+    return this->Jobs.count();
+}
+
+//
+//  job
+//
+// Return the job at a given position of the run
+//
+
+ResizeJob JobScheduler::job(int index) const
+{
+    QMutexLocker Locker(&this->Mutex);
+    return this->Jobs.at(index);
+}
+
+//
+//  recordJob
+//
+// Record the timing of the job at a given position of the run.
+// The lock is needed because jobs may be appended while others are recorded
+//
+
+void JobScheduler::recordJob(int index, qint64 startns, qint64 durationns)
+{
+    QMutexLocker Locker(&this->Mutex);
+    this->Starts[index]    = startns;
+    this->Durations[index] = durationns;
+}
+
+//
+//  setElapsed
+//
+// Record the wall-clock time of the whole run
+//
+
+void JobScheduler::setElapsed(qint64 elapsedns)
+{
+    this->Elapsed = elapsedns;
+}
+
+//
+//  calibratedNsPerPixel
+//
+// Ratio of the measured time to the estimated cost, over all the jobs which were run.
+// Using the ratio of the sums gives big pictures the weight they have on the makespan
+//
+
+double JobScheduler::calibratedNsPerPixel() const
+{
+    double TotalCost = 0.0;
+    double TotalTime = 0.0;
+    for (int i = 0; i < this->Jobs.count(); i++) {
+        if (this->Durations.at(i) >= 0) {
+            TotalCost += cost(this->Jobs.at(i));
+            TotalTime += double(this->Durations.at(i));
+        }
+    }
+
+    return ((TotalCost > 0.0) && (TotalTime > 0.0)) ? TotalTime / TotalCost : this->NsPerPixel;
+}
+
+//
+//  predictedMakespan
+//
+// Simulate the run: each job is taken, in order, by the first worker which becomes free
+//
+
+double JobScheduler::predictedMakespan(double nsperpixel) const
+{
+    std::priority_queue<double, std::vector<double>, std::greater<double>> FreeAt;
+    for (int i = 0; i < this->Workers; i++) {
+        FreeAt.push(0.0);
+    }
+
+    double Makespan = 0.0;
+    for (int i = 0; i < this->Jobs.count(); i++) {
+        if (this->Durations.at(i) < 0) {
+            continue;
+        }
+        double End = FreeAt.top() + cost(this->Jobs.at(i)) * nsperpixel;
+        FreeAt.pop();
+        FreeAt.push(End);
+        Makespan = qMax(Makespan, End);
+    }
+
+    return Makespan;
+}
+
+//
+//  report
+//
+// Compare the predicted runtimes with the measured ones. The prediction uses the coefficient known before the run,
+// the "calibrated" figures show what the cost model alone is worth, whatever the speed of the machine
+//
+
+QString JobScheduler::report() const
+{
+    int             Count      = 0;
+    QVector<double> Errors;
+    qint64          LastEnd    = 0;
+    qint64          LastStart  = 0;
+    double          Calibrated = calibratedNsPerPixel();
+    for (int i = 0; i < this->Jobs.count(); i++) {
+        qint64 Duration = this->Durations.at(i);
+        if (Duration < 0) {
+            continue;
+        }
+        Count++;
+        LastEnd   = qMax(LastEnd, this->Starts.at(i) + Duration);
+        LastStart = qMax(LastStart, this->Starts.at(i));
+        if (Duration > 0) {
+            Errors << qAbs(cost(this->Jobs.at(i)) * Calibrated - double(Duration)) / double(Duration);
+        }
+    }
+
+    double Mean   = 0.0;
+    double Median = 0.0;
+    if (!Errors.isEmpty()) {
+        for (double Error : Errors) {
+            Mean += Error;
+        }
+        Mean /= Errors.count();
+        std::sort(Errors.begin(), Errors.end());
+        Median = Errors.at(Errors.count() / 2);
+    }
+
+    double Predicted          = predictedMakespan(this->NsPerPixel);
+    double CalibratedMakespan = predictedMakespan(Calibrated);
+    double Actual             = double(this->Elapsed);
+    auto   seconds            = [](double ns) { return QString::number(ns / 1e9, 'f', 3); };
+    auto   deviation          = [Actual](double ns) { return Actual > 0.0 ? QString::number((ns - Actual) * 100.0 / Actual, 'f', 1) : QString("n/a"); };
+
+    QString     Report;
+    QTextStream Stream(&Report);
+    Stream << "Scheduling report\n";
+    Stream << "  Policy: " << policyName(this->Scheduling) << ", workers: " << this->Workers << ", jobs: " << Count << "/" << this->Jobs.count() << "\n";
+    Stream << "  Cost coefficient: " << QString::number(this->NsPerPixel, 'f', 2) << " ns/pixel predicted, " << QString::number(Calibrated, 'f', 2)
+           << " ns/pixel measured\n";
+    Stream << "  Makespan: " << seconds(Actual) << " s actual, " << seconds(Predicted) << " s predicted (" << deviation(Predicted) << "%), " << seconds(CalibratedMakespan)
+           << " s with the measured coefficient (" << deviation(CalibratedMakespan) << "%)\n";
+    Stream << "  Tail: " << seconds(double(LastEnd - LastStart)) << " s between the start of the last job and the end of the run\n";
+    Stream << "  Per-job error with the measured coefficient: " << QString::number(Mean * 100.0, 'f', 1) << "% mean, "
+           << QString::number(Median * 100.0, 'f', 1) << "% median\n";
+    return Report;
+}
+
+//
+//  writeCsv
+//
+// Write one line per job, in execution order, to tune the cost model offline
+//
+
+bool JobScheduler::writeCsv(const QString& filename) const
+{
+    QFile File(filename);
+    if (!File.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return false;
+    }
+
+    QTextStream Stream(&File);
+    Stream << "order,id,filename,org_width,org_height,new_width,new_height,cost,predicted_ms,start_ms,actual_ms\n";
+    for (int i = 0; i < this->Jobs.count(); i++) {
+        const ResizeJob& Job      = this->Jobs.at(i);
+        QString          Filename = Job.Filename;
+        Filename.replace('"', "\"\"");
+        Stream << i << "," << Job.Id << ",\"" << Filename << "\"," << Job.OrgSize.width() << "," << Job.OrgSize.height() << "," << Job.NewSize.width() << ","
+               << Job.NewSize.height() << "," << QString::number(cost(Job), 'f', 0) << "," << QString::number(cost(Job) * this->NsPerPixel / 1e6, 'f', 3) << ","
+               << QString::number(this->Starts.at(i) / 1e6, 'f', 3) << ","
+               << (this->Durations.at(i) < 0 ? QString() : QString::number(this->Durations.at(i) / 1e6, 'f', 3)) << "\n";
+    }
+
+    return Stream.status() == QTextStream::Ok;
+}
+
+//
+//  policyName
+//
+// Name of a policy, used in settings and reports
+//
+
+QString JobScheduler::policyName(Policy policy)
+{
+    switch (policy) {
+        case PolicyInput:
+            return "input";
+        case PolicyDirectoryLargestFirst:
+            return "directory";
+        case PolicyLargestFirst:
+        default:
+            return "largest";
+    }
+}
+
+//
+//  policyFromName
+//
+// Policy matching a name, or fallback if the name is unknown
+//
+
+JobScheduler::Policy JobScheduler::policyFromName(const QString& name, Policy fallback)
+{
+    for (Policy Candidate : {PolicyInput, PolicyLargestFirst, PolicyDirectoryLargestFirst}) {
+        if (name.compare(policyName(Candidate), Qt::CaseInsensitive) == 0) {
+            return Candidate;
+        }
+    }
+    return fallback;
+}
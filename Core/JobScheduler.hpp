@@ -0,0 +1,86 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef JOBSCHEDULER_HPP
+#define JOBSCHEDULER_HPP
+
+#include "ResizeJob.hpp"
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+//
+//  Default cost coefficient, used before any calibration. Measured runs replace it
+//
+
+#define DEFAULT_NS_PER_PIXEL 20.0
+
+//
+//  JobScheduler
+//
+// This class orders the resizing jobs before they are handed to the worker pool, and measures how good the order was.
+// The cost of a job is estimated from the known picture sizes (pixels decoded + pixels produced).
+// Largest-first gives a better makespan: big panoramas don't end up alone on one core at the end of a run.
+// Directory grouping keeps the files of a directory together, for disk locality, and still starts with the costliest groups.
+// After the run, the predicted durations are compared with the measured ones, and the cost model is recalibrated.
+// Jobs may be appended while the run is in progress (streaming mode): each batch is ordered on its own
+//
+
+class JobScheduler
+{
+  public:
+    enum Policy {
+        PolicyInput,                 // Keep the order of the table
+        PolicyLargestFirst,          // Costliest jobs first
+        PolicyDirectoryLargestFirst, // Group by directory, costliest groups first, costliest jobs first in a group
+    };
+
+    JobScheduler(Policy policy = PolicyLargestFirst, int workers = 1, double nsperpixel = DEFAULT_NS_PER_PIXEL);
+
+    void             reset(Policy policy, int workers, double nsperpixel);    // Forget the jobs of the previous run, and set the parameters of the next one
+    QList<ResizeJob> order(const QList<ResizeJob>& jobs) const;               // Return the jobs ordered according to the policy
+    void             append(const QList<ResizeJob>& jobs);                    // Order a batch of jobs, and append it to the run. Thread-safe
+    int              count() const;                                           // Number of jobs of the run. Thread-safe
+    ResizeJob        job(int index) const;                                    // Job at a given position. Thread-safe
+    void             recordJob(int index, qint64 startns, qint64 durationns); // Record the timing of the job at a given position. Thread-safe
+    void             setElapsed(qint64 elapsedns);                            // Record the wall-clock time of the run
+    double           calibratedNsPerPixel() const;                            // Cost coefficient measured during the run, or the initial one if nothing was measured. Call once the run is over
+    QString          report() const;                                          // Human-readable comparison of predicted and actual runtimes. Call once the run is over
+    bool             writeCsv(const QString& filename) const;                 // Write per-job predictions and measures. Call once the run is over
+
+    static double  cost(const ResizeJob& job);                           // Estimated cost of a job, in pixels
+    static QString policyName(Policy policy);                            // Name used in settings and reports
+    static Policy  policyFromName(const QString& name, Policy fallback); // Policy matching a name, or fallback if unknown
+
+  private:
+    double predictedMakespan(double nsperpixel) const; // Simulate the run on the worker pool with predicted durations
+
+    Policy           Scheduling; // Ordering policy
+    int              Workers;    // Number of workers of the pool
+    double           NsPerPixel; // Cost coefficient used for the predictions
+    QList<ResizeJob> Jobs;       // Ordered jobs
+    QVector<qint64>  Starts;     // Start time of each job, relative to the beginning of the run
+    QVector<qint64>  Durations;  // Time spent processing each job, waits in the queues excluded, -1 if the job was not run
+    qint64           Elapsed;    // Wall-clock time of the run
+    mutable QMutex   Mutex;      // Control access to the jobs and their timings while the run is in progress
+};
+
+#endif // JOBSCHEDULER_HPP
@@ -0,0 +1,255 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "QualitySearch.hpp"
+#include <QBuffer>
+#include <QImageWriter>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <cmath>
+
+//
+//  QualitySearch
+//
+// Constructor. Width is the number of candidates encoded in parallel at each round, 1 to search in the calling thread only
+//
+
+QualitySearch::QualitySearch(const QByteArray& format, qint64 budget, int width)
+    : Format(format)
+    , Budget(budget)
+    , Width(qMax(width, 1))
+    , Low(QUALITY_SEARCH_MIN - 1)
+    , LowSize(0)
+    , High(QUALITY_SEARCH_MAX + 1)
+    , HighSize(0)
+    , SmallestQuality(-1)
+    , Failed(false)
+    , Quality(-1)
+    , Encodes(0)
+{
+}
+
+//
+//  run
+//
+// Search the best encoding of a picture. The first round tries the highest quality, which often fits, and spreads
+// the other candidates over the range. Then the candidates are centered on the quality where the size is expected
+// to meet the budget, interpolating the logarithm of the size between the bounds of the bracket, which is close
+// to linear for JPEG and WebP. When the bracket is narrow enough, all the remaining qualities are tried at once.
+// May be called again on a smaller version of the picture
+//
+
+bool QualitySearch::run(const QImage& image)
+{
+    this->Low      = QUALITY_SEARCH_MIN - 1;
+    this->High     = QUALITY_SEARCH_MAX + 1;
+    this->LowSize  = 0;
+    this->HighSize = 0;
+    this->Failed   = false;
+    this->LowData.clear();
+    this->Smallest.clear();
+    this->SmallestQuality = -1;
+
+    // Nothing to search, the encoder gives what it gives
+    if (!hasQuality(this->Format)) {
+        this->Data    = encode(image, this->Format, -1);
+        this->Quality = -1;
+        this->Encodes++;
+        return !this->Data.isEmpty() && (this->Data.size() <= this->Budget);
+    }
+
+    QVector<int> Candidates = spread(QUALITY_SEARCH_MIN, QUALITY_SEARCH_MAX, this->Width - 1);
+    Candidates.prepend(QUALITY_SEARCH_MAX);
+    for (int Round = 0; (Round < QUALITY_SEARCH_MAX_ROUNDS) && !this->Failed; Round++) {
+        evaluate(image, Candidates);
+        if (this->High - this->Low <= 1) {
+            break;
+        }
+
+        // Nothing fits yet: try the lowest qualities
+        if (this->Low < QUALITY_SEARCH_MIN) {
+            Candidates = spread(QUALITY_SEARCH_MIN, this->High, this->Width);
+            continue;
+        }
+
+        // Few qualities left, try them all
+        Candidates.clear();
+        if (this->High - this->Low - 1 <= this->Width) {
+            for (int Value = this->Low + 1; Value < this->High; Value++) {
+                Candidates << Value;
+            }
+            continue;
+        }
+
+        // The budget lies between the sizes of the bounds, so the position is in [0, 1)
+        double Position  = (std::log(double(this->Budget)) - std::log(double(this->LowSize))) / (std::log(double(this->HighSize)) - std::log(double(this->LowSize)));
+        int    Predicted = this->Low + qRound(Position * (this->High - this->Low));
+        int    Step      = qMax(1, (this->High - this->Low) / (2 * this->Width));
+        for (int i = 0; i < this->Width; i++) {
+            int Value = qBound(this->Low + 1, Predicted + (i - this->Width / 2) * Step, this->High - 1);
+            if (!Candidates.contains(Value)) {
+                Candidates << Value;
+            }
+        }
+    }
+
+    if (this->Failed) {
+        this->Data.clear();
+        this->Quality = -1;
+        return false;
+    }
+    if (this->Low >= QUALITY_SEARCH_MIN) {
+        this->Data    = this->LowData;
+        this->Quality = this->Low;
+        return true;
+    }
+    this->Data    = this->Smallest;
+    this->Quality = this->SmallestQuality;
+    return false;
+}
+
+//
+//  evaluate
+//
+// Encode the picture at several qualities. The first one is encoded by the calling thread, the others by the pool
+// of the searches, so a search never waits for a free thread to make progress. Then narrow the bracket.
+// Sizes are compared to the budget one by one: an encoder which is not strictly monotonic can't break the search
+//
+
+void QualitySearch::evaluate(const QImage& image, const QVector<int>& qualities)
+{
+    static QThreadPool Pool;
+
+    QVector<QByteArray> Results(qualities.count());
+    QByteArray*         Slots = Results.data();
+    QSemaphore          Done;
+    for (int i = 1; i < qualities.count(); i++) {
+        Pool.start([&image, &Done, Slots, i, qualities, this]() {
+            Slots[i] = encode(image, this->Format, qualities.at(i));
+            Done.release();
+        });
+    }
+    Slots[0] = encode(image, this->Format, qualities.at(0));
+    Done.acquire(qualities.count() - 1);
+    this->Encodes += qualities.count();
+
+    for (int i = 0; i < qualities.count(); i++) {
+        const QByteArray& Result = Results.at(i);
+        int               Value  = qualities.at(i);
+        if (Result.isEmpty()) {
+            this->Failed = true;
+            continue;
+        }
+        if (this->Smallest.isEmpty() || (Result.size() < this->Smallest.size())) {
+            this->Smallest        = Result;
+            this->SmallestQuality = Value;
+        }
+        if ((Result.size() <= this->Budget) && (Value > this->Low)) {
+            this->Low     = Value;
+            this->LowSize = Result.size();
+            this->LowData = Result;
+        }
+        else if ((Result.size() > this->Budget) && (Value < this->High)) {
+            this->High     = Value;
+            this->HighSize = Result.size();
+        }
+    }
+}
+
+//
+//  data
+//
+// Result of the last search: the best encoding which fits, or the smallest one if none fits. Empty if the encoder failed
+//
+
+QByteArray QualitySearch::data() const
+{
+    return this->Data;
+}
+
+//
+//  quality
+//
+// Quality of the result of the last search, -1 if the format has no quality setting
+//
+
+int QualitySearch::quality() const
+{
+    return this->Quality;
+}
+
+//
+//  encodes
+//
+// Number of encodings done by all the searches of this object
+//
+
+int QualitySearch::encodes() const
+{
+    return this->Encodes;
+}
+
+//
+//  hasQuality
+//
+// Return true if the size of a format is driven by its quality setting, which is what the search explores.
+// Lossless formats ignore it, or use it as a compression effort
+//
+
+bool QualitySearch::hasQuality(const QByteArray& format)
+{
+    return (format == "jpg") || (format == "jpeg") || (format == "jpe") || (format == "webp");
+}
+
+//
+//  encode
+//
+// Encode a picture to memory at a given quality, -1 for the default one of the format. Empty on failure.
+// Thread-safe: each call has its own writer, and the picture is only read
+//
+
+QByteArray QualitySearch::encode(const QImage& image, const QByteArray& format, int quality)
+{
+    QByteArray Result;
+    QBuffer    Buffer(&Result);
+    Buffer.open(QIODevice::WriteOnly);
+    QImageWriter Writer(&Buffer, format);
+    Writer.setQuality(quality);
+    if (!Writer.write(image)) {
+        return QByteArray();
+    }
+    Buffer.close();
+    return Result;
+}
+
+//
+//  spread
+//
+// Return count qualities evenly spaced from first, included, to last, excluded
+//
+
+QVector<int> QualitySearch::spread(int first, int last, int count)
+{
+    QVector<int> Qualities;
+    for (int i = 0; i < count; i++) {
+        Qualities << first + i * (last - first) / count;
+    }
+    return Qualities;
+}
@@ -0,0 +1,93 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef QUALITYSEARCH_HPP
+#define QUALITYSEARCH_HPP
+
+#include <QByteArray>
+#include <QImage>
+#include <QVector>
+
+//
+//  QualitySearch
+//
+// This class encodes a picture under a byte budget, with the best quality which fits.
+// The encoded size grows with the quality, so the search keeps a bracket: the best quality known to fit,
+// and the lowest one known to exceed the budget. Each round encodes a few candidates in parallel, around the quality
+// interpolated from the sizes of the bounds, until the bounds are adjacent. A handful of encodings is usually enough.
+// Formats without quality setting are encoded once
+//
+
+class QualitySearch
+{
+  public:
+    QualitySearch(const QByteArray& format, qint64 budget, int width);
+    bool        run(const QImage& image);             // Search the best encoding of a picture. Return false if even the lowest quality exceeds the budget
+    QByteArray  data() const;                         // Result of the last search: best encoding which fits, or the smallest one. Empty if the encoder failed
+    int         quality() const;                      // Quality of the result, -1 for the default one
+    int         encodes() const;                      // Number of encodings done by all the searches
+    static bool hasQuality(const QByteArray& format); // True if the size of a format is driven by its quality setting
+
+  private:
+    void                evaluate(const QImage& image, const QVector<int>& qualities);       // Encode the picture at several qualities in parallel, and narrow the bracket
+    static QByteArray   encode(const QImage& image, const QByteArray& format, int quality); // Encode a picture to memory. Empty on failure
+    static QVector<int> spread(int first, int last, int count);                             // Evenly spaced qualities, from first included to last excluded
+
+    QByteArray Format;          // Format of the encodings
+    qint64     Budget;          // Maximum size of the result, in bytes
+    int        Width;           // Number of candidates encoded in parallel
+    int        Low;             // Best quality known to fit, below QUALITY_SEARCH_MIN if none
+    qint64     LowSize;         // Size of the encoding at Low
+    QByteArray LowData;         // Encoding at Low
+    int        High;            // Lowest quality known to exceed the budget, above QUALITY_SEARCH_MAX if none
+    qint64     HighSize;        // Size of the encoding at High
+    QByteArray Smallest;        // Smallest encoding, used if nothing fits
+    int        SmallestQuality; // Quality of the smallest encoding
+    bool       Failed;          // An encoding failed
+    QByteArray Data;            // Result of the last search
+    int        Quality;         // Quality of the result
+    int        Encodes;         // Number of encodings done by all the searches
+};
+
+//
+//  Lowest quality tried. Below, artifacts are worse than a smaller picture
+//
+
+#define QUALITY_SEARCH_MIN 30
+
+//
+//  Highest quality tried. Above, files grow without visible gain
+//
+
+#define QUALITY_SEARCH_MAX 95
+
+//
+//  Default number of candidates encoded in parallel at each round of the search
+//
+
+#define QUALITY_SEARCH_WIDTH 3
+
+//
+//  Maximum number of rounds of a search. The best quality found so far is used if the bracket has not converged
+//
+
+#define QUALITY_SEARCH_MAX_ROUNDS 8
+
+#endif // QUALITYSEARCH_HPP
@@ -0,0 +1,431 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "Resampler.hpp"
+#include "BufferPool.hpp"
+#include "WeightCache.hpp"
+#include <QColorSpace>
+#include <QRgb>
+#include <QRgba64>
+#include <QtGlobal>
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+//
+//  Alpha channel position in a premultiplied ARGB32 pixel, depending on the byte order
+//
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+#define ARGB32_ALPHA_INDEX 3
+#else
+#define ARGB32_ALPHA_INDEX 0
+#endif
+
+namespace {
+
+    //
+    //  convertRow
+    //
+    // Convert a resampled row to another color space. Transforms work on unpremultiplied colors, so premultiplied pixels
+    // are unpremultiplied first. Grayscale rows have no color to convert, they are left untouched
+    //
+
+    template<typename T, int Channels, int AlphaIndex>
+    void convertRow(T* line, int width, const QColorTransform& transform)
+    {
+        if constexpr ((sizeof(T) == 1) && (Channels == 4)) {
+            QRgb* Pixels = reinterpret_cast<QRgb*>(line);
+            for (int x = 0; x < width; x++) {
+                Pixels[x] = AlphaIndex >= 0 ? qPremultiply(transform.map(qUnpremultiply(Pixels[x]))) : transform.map(Pixels[x]);
+            }
+        }
+        else if constexpr ((sizeof(T) == 1) && (Channels == 3)) {
+            for (int x = 0; x < width; x++) {
+                T*   Pixel = line + x * 3;
+                QRgb Color = transform.map(qRgb(Pixel[0], Pixel[1], Pixel[2]));
+                Pixel[0]   = T(qRed(Color));
+                Pixel[1]   = T(qGreen(Color));
+                Pixel[2]   = T(qBlue(Color));
+            }
+        }
+        else if constexpr ((sizeof(T) == 2) && (Channels == 4)) {
+            QRgba64* Pixels = reinterpret_cast<QRgba64*>(line);
+            for (int x = 0; x < width; x++) {
+                Pixels[x] = AlphaIndex >= 0 ? transform.map(Pixels[x].unpremultiplied()).premultiplied() : transform.map(Pixels[x]);
+            }
+        }
+        else {
+            Q_UNUSED(line)
+            Q_UNUSED(width)
+            Q_UNUSED(transform)
+        }
+    }
+
+    //
+    //  resample
+    //
+    // Separable resampling kernel. T is the channel type, Channels the number of channels per pixel,
+    // AlphaIndex the position of a premultiplied alpha channel (-1 if none), used to keep color <= alpha.
+    // Source rows are filtered horizontally once, into a ring buffer holding the rows needed by the vertical pass.
+    // If a color transform is given, each target row is converted as soon as it's stored, while it's still in the cache
+    //
+
+    template<typename T, int Channels, int AlphaIndex>
+    void resample(const QImage& source, QImage& target, const ResampleWeights& horizontal, const ResampleWeights& vertical, const QColorTransform* transform)
+    {
+        const int    TargetWidth = target.width();
+        const int    RowLength   = TargetWidth * Channels;
+        const int    RingSize    = vertical.Taps;
+        const double MaxValue    = std::numeric_limits<T>::max();
+
+        std::vector<float> Ring(size_t(RingSize) * RowLength);
+        std::vector<int>   RingRow(RingSize, -1);
+        std::vector<float> Accumulator(RowLength);
+
+        // Return the horizontally filtered source row, computing it if it's not in the ring yet
+        auto filteredRow = [&](int y) -> const float* {
+            int    Slot = y % RingSize;
+            float* Row  = Ring.data() + size_t(Slot) * RowLength;
+            if (RingRow[Slot] != y) {
+                const T* Line = reinterpret_cast<const T*>(source.constScanLine(y));
+                for (int x = 0; x < TargetWidth; x++) {
+                    const float* Weights = horizontal.Weights.constData() + size_t(x) * horizontal.Taps;
+                    const T*     Pixel   = Line + size_t(horizontal.Start.at(x)) * Channels;
+                    float        Sum[Channels] = {};
+                    for (int t = 0; t < horizontal.Count.at(x); t++) {
+                        for (int c = 0; c < Channels; c++) {
+                            Sum[c] += Weights[t] * Pixel[t * Channels + c];
+                        }
+                    }
+                    for (int c = 0; c < Channels; c++) {
+                        Row[x * Channels + c] = Sum[c];
+                    }
+                }
+                RingRow[Slot] = y;
+            }
+            return Row;
+        };
+
+        for (int y = 0; y < target.height(); y++) {
+            // Vertical pass
+            std::fill(Accumulator.begin(), Accumulator.end(), 0.0f);
+            const float* Weights = vertical.Weights.constData() + size_t(y) * vertical.Taps;
+            for (int t = 0; t < vertical.Count.at(y); t++) {
+                const float* Row    = filteredRow(vertical.Start.at(y) + t);
+                float        Weight = Weights[t];
+                for (int i = 0; i < RowLength; i++) {
+                    Accumulator[i] += Weight * Row[i];
+                }
+            }
+
+            // Round, clamp, and store in the native format
+            T* Line = reinterpret_cast<T*>(target.scanLine(y));
+            for (int x = 0; x < TargetWidth; x++) {
+                double Alpha = MaxValue;
+                if (AlphaIndex >= 0) {
+                    Alpha = qBound(0.0, double(Accumulator[x * Channels + AlphaIndex]) + 0.5, MaxValue);
+                }
+                for (int c = 0; c < Channels; c++) {
+                    double Value = qBound(0.0, double(Accumulator[x * Channels + c]) + 0.5, c == AlphaIndex ? MaxValue : Alpha);
+                    Line[x * Channels + c] = T(Value);
+                }
+            }
+            if (transform != nullptr) {
+                convertRow<T, Channels, AlphaIndex>(Line, TargetWidth, *transform);
+            }
+        }
+    }
+
+} // namespace
+
+//
+//  resize
+//
+// Resize a picture, keeping its pixel format when possible. Formats that can't be filtered as they are
+// (non-premultiplied alpha, palettes, packed formats) are converted first, and converted back when it makes sense.
+// If a color transform is given, the result is converted with it during the resampling, which is much cheaper than
+// converting the source picture: only the target pixels are converted. Grayscale pictures are not converted
+//
+
+QImage Resampler::resize(const QImage& image, QSize size, Filter filter, const QColorTransform* transform)
+{
+    if (image.isNull() || size.isEmpty()) {
+        return QImage();
+    }
+
+    // Choose the working format, and the format of the result
+    QImage         Source       = image;
+    QImage::Format ResultFormat = QImage::Format_Invalid; // Invalid: keep the working format
+    switch (image.format()) {
+        case QImage::Format_Grayscale8:
+        case QImage::Format_Grayscale16:
+        case QImage::Format_RGB888:
+        case QImage::Format_RGB32:
+        case QImage::Format_ARGB32_Premultiplied:
+        case QImage::Format_RGBX64:
+        case QImage::Format_RGBA64_Premultiplied:
+            break;
+
+        case QImage::Format_ARGB32:
+            Source       = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+            ResultFormat = QImage::Format_ARGB32;
+            break;
+
+        case QImage::Format_RGBA64:
+            Source       = image.convertToFormat(QImage::Format_RGBA64_Premultiplied);
+            ResultFormat = QImage::Format_RGBA64;
+            break;
+
+        case QImage::Format_Mono:
+        case QImage::Format_MonoLSB:
+        case QImage::Format_Indexed8:
+            // A palette can't be interpolated: expand it to the smallest format able to hold its colors
+            if (image.allGray() && !image.hasAlphaChannel()) {
+                Source = image.convertToFormat(QImage::Format_Grayscale8);
+            }
+            else if (image.hasAlphaChannel()) {
+                Source       = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+                ResultFormat = QImage::Format_ARGB32;
+            }
+            else {
+                Source = image.convertToFormat(QImage::Format_RGB32);
+            }
+            break;
+
+        default:
+            // Other formats are processed in the closest native format, then converted back
+            if (image.depth() > 32) {
+                Source = image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_RGBA64_Premultiplied : QImage::Format_RGBX64);
+            }
+            else {
+                Source = image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+            }
+            ResultFormat = image.format();
+            break;
+    }
+
+    QImage Target = BufferPool::instance()->image(size, Source.format());
+    if (Source.isNull() || Target.isNull()) {
+        return QImage();
+    }
+
+    // A grayscale picture keeps its gray color space
+    if ((Source.format() == QImage::Format_Grayscale8) || (Source.format() == QImage::Format_Grayscale16)) {
+        transform = nullptr;
+    }
+
+    // Coefficient tables are shared by all the pictures of a batch with the same dimensions
+    WeightCache::Weights Horizontal = WeightCache::instance()->weights(Source.width(), size.width(), filter);
+    WeightCache::Weights Vertical   = WeightCache::instance()->weights(Source.height(), size.height(), filter);
+
+    switch (Source.format()) {
+        case QImage::Format_Grayscale8:
+            resample<quint8, 1, -1>(Source, Target, *Horizontal, *Vertical, transform);
+            break;
+        case QImage::Format_Grayscale16:
+            resample<quint16, 1, -1>(Source, Target, *Horizontal, *Vertical, transform);
+            break;
+        case QImage::Format_RGB888:
+            resample<quint8, 3, -1>(Source, Target, *Horizontal, *Vertical, transform);
+            break;
+        case QImage::Format_RGB32:
+            resample<quint8, 4, -1>(Source, Target, *Horizontal, *Vertical, transform);
+            break;
+        case QImage::Format_ARGB32_Premultiplied:
+            resample<quint8, 4, ARGB32_ALPHA_INDEX>(Source, Target, *Horizontal, *Vertical, transform);
+            break;
+        case QImage::Format_RGBX64:
+            resample<quint16, 4, -1>(Source, Target, *Horizontal, *Vertical, transform);
+            break;
+        case QImage::Format_RGBA64_Premultiplied:
+            resample<quint16, 4, 3>(Source, Target, *Horizontal, *Vertical, transform);
+            break;
+        default:
+            return QImage();
+    }
+
+    // Keep the metadata of the original picture
+    Target.setDotsPerMeterX(image.dotsPerMeterX());
+    Target.setDotsPerMeterY(image.dotsPerMeterY());
+    Target.setColorSpace(transform != nullptr ? QColorSpace(QColorSpace::SRgb) : image.colorSpace());
+
+    return ResultFormat == QImage::Format_Invalid ? Target : Target.convertToFormat(ResultFormat);
+}
+
+//
+//  isNativeFormat
+//
+// Return true if a format is resampled without any conversion
+//
+
+bool Resampler::isNativeFormat(QImage::Format format)
+{
+    switch (format) {
+        case QImage::Format_Grayscale8:
+        case QImage::Format_Grayscale16:
+        case QImage::Format_RGB888:
+        case QImage::Format_RGB32:
+        case QImage::Format_ARGB32_Premultiplied:
+        case QImage::Format_RGBX64:
+        case QImage::Format_RGBA64_Premultiplied:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//
+//  support
+//
+// Return the radius of a filter, at scale 1
+//
+
+double Resampler::support(Filter filter)
+{
+    switch (filter) {
+        case FilterBox:
+            return 0.5;
+        case FilterLanczos3:
+            return 3.0;
+        default:
+            return 1.0;
+    }
+}
+
+//
+//  kernel
+//
+// Return the value of a filter at a given distance from the center
+//
+
+double Resampler::kernel(Filter filter, double x)
+{
+    x = qAbs(x);
+    switch (filter) {
+        case FilterBox:
+            return x <= 0.5 ? 1.0 : 0.0;
+
+        case FilterLanczos3: {
+            if (x < 1e-8) {
+                return 1.0;
+            }
+            if (x >= 3.0) {
+                return 0.0;
+            }
+            double PiX = M_PI * x;
+            return 3.0 * qSin(PiX) * qSin(PiX / 3.0) / (PiX * PiX);
+        }
+
+        default:
+            return x < 1.0 ? 1.0 - x : 0.0;
+    }
+}
+
+//
+//  filterName
+//
+// Return the name of a filter
+//
+
+QString Resampler::filterName(Filter filter)
+{
+    switch (filter) {
+        case FilterBox:
+            return "box";
+        case FilterLanczos3:
+            return "lanczos3";
+        default:
+            return "triangle";
+    }
+}
+
+//
+//  filterFromName
+//
+// Return the filter matching a name, or the fallback value if the name is unknown
+//
+
+Resampler::Filter Resampler::filterFromName(const QString& name, Filter fallback)
+{
+    QString Name = name.trimmed().toLower();
+    if (Name == "box") {
+        return FilterBox;
+    }
+    if (Name == "triangle") {
+        return FilterTriangle;
+    }
+    if (Name == "lanczos3") {
+        return FilterLanczos3;
+    }
+    return fallback;
+}
+
+//
+//  ResampleWeights
+//
+// Compute the coefficients of one axis. When downscaling, the filter is widened by the scale factor
+// so every source pixel contributes (area-like behavior). Weights are normalized to 1
+//
+
+ResampleWeights::ResampleWeights(int source, int target, Resampler::Filter filter)
+    : Source(source)
+    , Target(target)
+{
+    double Scale       = double(source) / target;
+    double FilterScale = qMax(1.0, Scale);
+    double Support     = Resampler::support(filter) * FilterScale;
+
+    this->Taps = qMin(source, int(qCeil(Support * 2.0)) + 2);
+    this->Start.resize(target);
+    this->Count.resize(target);
+    this->Weights.fill(0.0f, target * this->Taps);
+
+    for (int x = 0; x < target; x++) {
+        double Center = (x + 0.5) * Scale;
+        int    Left   = qMax(0, qFloor(Center - Support));
+        int    Right  = qMin(source, qCeil(Center + Support)); // Exclusive
+        Right         = qMin(Right, Left + this->Taps);
+
+        float* Weights = this->Weights.data() + size_t(x) * this->Taps;
+        double Sum     = 0.0;
+        for (int i = Left; i < Right; i++) {
+            double Weight     = Resampler::kernel(filter, (i + 0.5 - Center) / FilterScale);
+            Weights[i - Left] = float(Weight);
+            Sum              += Weight;
+        }
+
+        // Degenerated case (box filter between two pixels): take the nearest pixel
+        if (qAbs(Sum) < 1e-12) {
+            Left  = qBound(0, int(Center), source - 1);
+            Right = Left + 1;
+            std::fill(Weights, Weights + this->Taps, 0.0f);
+            Weights[0] = 1.0f;
+            Sum        = 1.0;
+        }
+
+        for (int i = 0; i < Right - Left; i++) {
+            Weights[i] = float(Weights[i] / Sum);
+        }
+        this->Start[x] = Left;
+        this->Count[x] = Right - Left;
+    }
+}
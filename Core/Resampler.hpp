@@ -0,0 +1,77 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef RESAMPLER_HPP
+#define RESAMPLER_HPP
+
+#include <QColorTransform>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+//
+//  Resampler
+//
+// This class resizes pictures with a separable filter, keeping them in their native pixel format
+// (Grayscale8, Grayscale16, RGB888, RGB32, RGBX64 and premultiplied ARGB32/RGBA64).
+// Each format has its own template-specialized kernel, so an 8-bit grayscale scan is processed as 1 byte per pixel,
+// while QImage::scaled() would convert it to 32 bits. Pictures are converted only when the filter requires it:
+// non-premultiplied alpha is premultiplied (and converted back), palettes and exotic formats are expanded.
+// A conversion to sRGB may be fused into the resampling
+//
+
+class Resampler
+{
+  public:
+    enum Filter {
+        FilterBox,      // Area average when downscaling, nearest neighbour when upscaling
+        FilterTriangle, // Bilinear, widened when downscaling. Close to Qt::SmoothTransformation
+        FilterLanczos3, // Sharpest, may ring a little on hard edges
+    };
+
+    static QImage  resize(const QImage& image, QSize size, Filter filter, const QColorTransform* transform = nullptr); // Return the resized picture, null on failure. Convert it to sRGB with the transform, if any
+    static bool    isNativeFormat(QImage::Format format);                                                           // True if a format is processed without conversion
+    static double  support(Filter filter);                                                                          // Radius of a filter, in source pixels at scale 1
+    static double  kernel(Filter filter, double x);                                                                 // Value of a filter at a given distance
+    static QString filterName(Filter filter);                                                                       // Name used in settings and reports
+    static Filter  filterFromName(const QString& name, Filter fallback);                                            // Filter matching a name, or fallback if unknown
+};
+
+//
+//  ResampleWeights
+//
+// Coefficients used to resample one axis: for each target pixel, the first source pixel,
+// the number of source pixels used, and their weights (normalized, Taps slots per target pixel)
+//
+
+struct ResampleWeights
+{
+    ResampleWeights(int source, int target, Resampler::Filter filter);
+
+    int            Source;  // Source length
+    int            Target;  // Target length
+    int            Taps;    // Number of weight slots per target pixel
+    QVector<int>   Start;   // First source pixel of each target pixel
+    QVector<int>   Count;   // Number of source pixels of each target pixel
+    QVector<float> Weights; // Target * Taps weights
+};
+
+#endif // RESAMPLER_HPP
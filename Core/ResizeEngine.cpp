@@ -0,0 +1,318 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "ResizeEngine.hpp"
+#include "BufferPool.hpp"
+#include "ColorTransformCache.hpp"
+#include "ExifThumbnail.hpp"
+#include "QualitySearch.hpp"
+#include "Resampler.hpp"
+#include "StageMetrics.hpp"
+#include "TraceRecorder.hpp"
+#include <QBuffer>
+#include <QDebug>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QImageWriter>
+#include <cmath>
+
+//
+//  ResizeEngine
+//
+// Constructor
+//
+
+ResizeEngine::ResizeEngine(const ResizeOptions& options)
+    : Options(options)
+{
+    this->ReadLimit.setRate(qint64(options.ReadBandwidth) * 1024 * 1024);
+    this->WriteLimit.setRate(qint64(options.WriteBandwidth) * 1024 * 1024);
+}
+
+//
+//  read
+//
+// I/O stage. Read the content of the file to resize. When the target is small, only the head of JPEG files is read first:
+// if the embedded EXIF preview is large enough, it's used instead of the full picture, which is orders of magnitude faster.
+// The quality guard rejects previews whose aspect ratio differs from the picture (some cameras add black bars),
+// and previews which are not at least twice as large as the target.
+// Each stage sets the reason of its failure in the task, and records its duration in the stage metrics when it succeeds.
+// Stages are also traced, so the timeline shows them whether they succeed or not.
+// The bandwidth cap is applied once the stage is measured, so the metrics show the storage, not the throttling
+//
+
+bool ResizeEngine::read(ResizeTask& task) const
+{
+    // The size known when the file was dropped is checked first, so an oversized file is not even read
+    if (!this->Options.Limits.accepts(task.Job.OrgSize)) {
+        task.Failure = ErrorRecords::ReasonTooLarge;
+        return false;
+    }
+
+    TraceScope    Trace("read", task.Job.Id);
+    QElapsedTimer Timer;
+    Timer.start();
+    task.Failure = ErrorRecords::ReasonUnreadable;
+    QFile File(task.Job.Filename);
+    if (!File.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QSize   Target = task.Job.NewSize;
+    QString Suffix = QFileInfo(task.Job.Filename).suffix().toLower();
+    if (this->Options.UseEmbeddedThumbnail && (qMax(Target.width(), Target.height()) <= EMBEDDED_THUMBNAIL_MAX_TARGET)
+        && ((Suffix == "jpg") || (Suffix == "jpeg") || (Suffix == "jpe"))) {
+        QByteArray    Head = File.read(EXIF_HEAD_SIZE);
+        ExifThumbnail Exif(Head);
+        QSize         Size   = Exif.size();
+        bool          Usable = Size.isValid() && (Size.width() >= Target.width()) && (Size.height() >= Target.height());
+
+        if (Usable && this->Options.ThumbnailQualityGuard) {
+            QSize  OrgSize = task.Job.OrgSize;
+            double Ratio   = double(OrgSize.width()) * Size.height() / (double(OrgSize.height()) * Size.width());
+            Usable         = (qAbs(Ratio - 1.0) < 0.01) && (Size.width() >= 2 * Target.width()) && (Size.height() >= 2 * Target.height());
+        }
+
+        if (Usable) {
+            task.Data    = Exif.data();
+            task.Preview = true;
+            task.Failure = ErrorRecords::ReasonNone;
+            StageMetrics::instance()->record(StageStatistics::StageRead, Timer.nsecsElapsed(), Head.size(), qint64(Size.width()) * Size.height());
+            this->ReadLimit.consume(Head.size());
+            return true;
+        }
+
+        Head.append(File.readAll());
+        task.Data = Head;
+    }
+    else {
+        task.Data = File.readAll();
+    }
+
+    if ((File.error() != QFileDevice::NoError) || task.Data.isEmpty()) {
+        return false;
+    }
+    task.Failure = ErrorRecords::ReasonNone;
+    StageMetrics::instance()->record(StageStatistics::StageRead, Timer.nsecsElapsed(), task.Data.size(), qint64(task.Job.OrgSize.width()) * task.Job.OrgSize.height());
+    this->ReadLimit.consume(task.Data.size());
+    return true;
+}
+
+//
+//  process
+//
+// CPU stage. Decode the picture from memory, resample it in its native pixel format, so the output keeps the bit depth
+// of the input, and encode the result in the format of the file. If enabled, the conversion to sRGB is part of the resampling.
+// The picture is decoded into a pooled buffer when the reader gives its size and format up front: QImageReader
+// then fills the provided image instead of allocating a new one.
+// Dimensions are checked again from the header, as the file may have changed since it was dropped.
+// The decoder reads its input through a buffer which fails once the per-file timeout has passed, so a slow decode
+// doesn't hold a worker until its end.
+// Decoding, resampling and encoding are measured apart, so a slow batch tells which one is to blame.
+// With a file size budget, the encoding stage includes the quality search
+//
+
+bool ResizeEngine::process(ResizeTask& task) const
+{
+    QByteArray     Format   = QFileInfo(task.Job.Filename).suffix().toLower().toLatin1();
+    qint64         Input    = task.Data.size();
+    QDeadlineTimer Deadline = this->Options.Limits.deadline(task.Elapsed);
+    bool           Expired  = false;
+    QImage         Image;
+    QElapsedTimer  Timer;
+    TraceScope     Decode("decode", task.Job.Id);
+    Timer.start();
+    {
+        DeadlineBuffer Buffer(&task.Data, Deadline);
+        QImageReader   Reader(&Buffer, task.Preview ? QByteArray("jpeg") : Format);
+        this->Options.Limits.apply(Reader);
+        QSize          Size        = Reader.size();
+        QImage::Format ImageFormat = Reader.imageFormat();
+        if (!this->Options.Limits.accepts(Size)) {
+            task.Failure = ErrorRecords::ReasonTooLarge;
+            return false;
+        }
+        if (Size.isValid() && (ImageFormat != QImage::Format_Invalid)) {
+            Image = BufferPool::instance()->image(Size, ImageFormat);
+        }
+        if (!Reader.read(&Image)) {
+            Image = QImage();
+        }
+        Expired = Buffer.hasExpired();
+    }
+
+    // The preview was validated from its header only. If it can't be decoded, fall back to the full picture
+    if (Image.isNull() && task.Preview && !Expired) {
+        QFile      File(task.Job.Filename);
+        QByteArray Content = File.open(QIODevice::ReadOnly) ? File.readAll() : QByteArray();
+        {
+            DeadlineBuffer Buffer(&Content, Deadline);
+            QImageReader   Reader(&Buffer, Format);
+            this->Options.Limits.apply(Reader);
+            if (!this->Options.Limits.accepts(Reader.size())) {
+                task.Failure = ErrorRecords::ReasonTooLarge;
+                return false;
+            }
+            Image   = Reader.read();
+            Expired = Buffer.hasExpired();
+        }
+    }
+
+    // A decoder stopped by the deadline may still give a picture, made of the data it got: it's discarded
+    if (Expired) {
+        task.Failure = ErrorRecords::ReasonTimeout;
+        return false;
+    }
+
+    qint64 Pixels = qint64(Image.width()) * Image.height();
+    if (!Image.isNull()) {
+        StageMetrics::instance()->record(StageStatistics::StageDecode, Timer.nsecsElapsed(), Input, Pixels);
+    }
+    Decode.finish();
+
+    // Pictures with another color profile are converted to sRGB while they are resampled.
+    // The transform is built once per profile, and shared by all the workers
+    TraceScope Resample("resample", task.Job.Id);
+    Timer.start();
+    ColorTransformCache::Transform Transform;
+    if (this->Options.ConvertToSrgb) {
+        Transform = ColorTransformCache::instance()->toSrgb(Image.colorSpace());
+    }
+    QImage ResizedImage = Resampler::resize(Image, task.Job.NewSize, this->Options.Filter, Transform.data());
+    task.Data.clear();
+    if (ResizedImage.isNull()) {
+        task.Failure = ErrorRecords::ReasonDecodeFailed;
+        return false;
+    }
+    StageMetrics::instance()->record(StageStatistics::StageResample, Timer.nsecsElapsed(), 0, Pixels);
+    Resample.finish();
+
+    TraceScope Encode("encode", task.Job.Id);
+    Timer.start();
+    if (this->Options.TargetSize != 0) {
+        ResizedImage = encodeToBudget(ResizedImage, Format, task);
+        if (task.Data.isEmpty()) {
+            task.Failure = ErrorRecords::ReasonEncodeFailed;
+            return false;
+        }
+    }
+    else {
+        QBuffer Buffer(&task.Data);
+        Buffer.open(QIODevice::WriteOnly);
+        if (!QImageWriter(&Buffer, Format).write(ResizedImage)) {
+            task.Failure = ErrorRecords::ReasonEncodeFailed;
+            return false;
+        }
+    }
+    task.Failure = ErrorRecords::ReasonNone;
+    StageMetrics::instance()->record(StageStatistics::StageEncode, Timer.nsecsElapsed(), task.Data.size(), qint64(ResizedImage.width()) * ResizedImage.height());
+    return true;
+}
+
+//
+//  encodeToBudget
+//
+// Encode a resampled picture with the best quality which fits in the file size budget. The search reuses the picture,
+// only the encoder runs again. If even the lowest quality exceeds the budget, the picture is made smaller, from the area
+// ratio given by the smallest encoding, and searched again. The result goes to the task, with its new size.
+// The smallest encoding is kept if the budget can't be met: the file is still resized, and a warning is logged.
+// In background mode, the candidates are encoded in the calling thread only
+//
+
+QImage ResizeEngine::encodeToBudget(const QImage& image, const QByteArray& format, ResizeTask& task) const
+{
+    qint64        Budget = qint64(this->Options.TargetSize) * 1024;
+    QualitySearch Search(format, Budget, this->Options.Background ? 1 : QUALITY_SEARCH_WIDTH);
+    QImage        Result = image;
+    bool          Fits   = Search.run(Result);
+    for (int i = 0; !Fits && this->Options.TargetDownscale && !Search.data().isEmpty() && (i < TARGET_SIZE_MAX_DOWNSCALES); i++) {
+        double Ratio = std::sqrt(TARGET_SIZE_DOWNSCALE_MARGIN * Budget / Search.data().size());
+        QSize  Size  = QSize(qMax(1, int(Result.width() * Ratio)), qMax(1, int(Result.height() * Ratio)));
+        QImage Image = Resampler::resize(Result, Size, this->Options.Filter);
+        if (Image.isNull() || (Size == Result.size())) {
+            break;
+        }
+        Result = Image;
+        Fits   = Search.run(Result);
+    }
+
+    task.Data        = Search.data();
+    task.Job.NewSize = Result.size();
+    if (!Fits && !task.Data.isEmpty()) {
+        qWarning().noquote() << QString("%1 exceeds the file size budget: %2 KB").arg(task.Job.Filename).arg((task.Data.size() + 1023) / 1024);
+    }
+    return Result;
+}
+
+//
+//  write
+//
+// I/O stage. Overwrite the original file with the encoded result
+//
+
+bool ResizeEngine::write(ResizeTask& task) const
+{
+    // Throttling is not part of the measured stage
+    this->WriteLimit.consume(task.Data.size());
+
+    TraceScope    Trace("write", task.Job.Id);
+    QElapsedTimer Timer;
+    Timer.start();
+    QFile File(task.Job.Filename);
+    bool  Success = File.open(QIODevice::WriteOnly | QIODevice::Truncate) && (File.write(task.Data) == task.Data.size());
+    task.Failure  = Success ? ErrorRecords::ReasonNone : ErrorRecords::ReasonWriteFailed;
+    if (Success) {
+        File.close();
+        StageMetrics::instance()->record(StageStatistics::StageWrite, Timer.nsecsElapsed(), task.Data.size(), qint64(task.Job.NewSize.width()) * task.Job.NewSize.height());
+    }
+    return Success;
+}
+
+//
+//  resize
+//
+// Run all the stages of a job in the calling thread. Used by the worker processes, which handle one file at a time.
+// If the job fails, stage and reason tell where and why
+//
+
+bool ResizeEngine::resize(const ResizeJob& job, ErrorRecords::Stage* stage, ErrorRecords::Reason* reason) const
+{
+    ResizeTask Task;
+    Task.Index   = 0;
+    Task.Job     = job;
+    Task.Preview = false;
+    Task.Failure = ErrorRecords::ReasonNone;
+    Task.Start   = 0;
+    Task.Elapsed = 0;
+
+    *stage = ErrorRecords::StageRead;
+    if (read(Task)) {
+        *stage = ErrorRecords::StageProcess;
+        if (process(Task)) {
+            *stage = ErrorRecords::StageWrite;
+            write(Task);
+        }
+    }
+    *reason = Task.Failure;
+    return Task.Failure == ErrorRecords::ReasonNone;
+}
@@ -0,0 +1,73 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef RESIZEENGINE_HPP
+#define RESIZEENGINE_HPP
+
+#include "ErrorLog.hpp"
+#include "ResizeJob.hpp"
+#include "ResizeOptions.hpp"
+#include "ResourceGovernor.hpp"
+#include <QByteArray>
+#include <QImage>
+
+//
+//  ResizeTask
+//
+// State of a job while it goes through the pipeline: read (I/O pool), decode/resample/encode (CPU pool), write (I/O pool)
+//
+
+struct ResizeTask
+{
+    int                  Index;   // Position of the job in the scheduled queue
+    ResizeJob            Job;     // Job description
+    QByteArray           Data;    // Content of the source file (or its embedded preview), then the encoded result
+    bool                 Preview; // True if Data holds the embedded preview instead of the whole file
+    ErrorRecords::Reason Failure; // Reason of the failure of the last stage, ReasonNone if it succeeded
+    qint64               Start;   // Time at which the job started, relative to the beginning of the process
+    qint64               Elapsed; // Time spent in the stages of the job, waits between stages excluded
+};
+
+//
+//  ResizeEngine
+//
+// This class holds the stages of a resizing job. They are independent, so they can run in different thread pools,
+// or one after the other in a worker process. The bandwidth caps are shared by all the threads using the engine
+//
+
+class ResizeEngine
+{
+  public:
+    explicit ResizeEngine(const ResizeOptions& options);
+
+    bool read(ResizeTask& task) const;                                                                 // I/O stage: read the file to resize, or only its embedded preview when it's enough
+    bool process(ResizeTask& task) const;                                                              // CPU stage: decode, resample and encode
+    bool write(ResizeTask& task) const;                                                                // I/O stage: write the result
+    bool resize(const ResizeJob& job, ErrorRecords::Stage* stage, ErrorRecords::Reason* reason) const; // Run all the stages in the calling thread. Give the failed stage and the reason
+
+  private:
+    QImage encodeToBudget(const QImage& image, const QByteArray& format, ResizeTask& task) const; // Encode a picture under the file size budget, smaller if needed. Return the encoded picture
+
+    ResizeOptions       Options;    // Engine settings
+    mutable TokenBucket ReadLimit;  // Read bandwidth cap
+    mutable TokenBucket WriteLimit; // Write bandwidth cap
+};
+
+#endif // RESIZEENGINE_HPP
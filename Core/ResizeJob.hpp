@@ -18,22 +18,25 @@
  * mail: martial <dot> demolins <at> gmail <dot> com
  */
 
-#ifndef TABLEITEM_HPP
-#define TABLEITEM_HPP
+#ifndef RESIZEJOB_HPP
+#define RESIZEJOB_HPP
 
+#include <QSize>
 #include <QString>
-#include <QTableWidgetItem>
 
 //
-//  TableItem
+//  ResizeJob
 //
-// This class is a QTableWidgetItem which centers its content
+// Description of a file to resize. The id is given by the caller (the store id of the file),
+// and is sent back by the resize thread so the UI knows which file has been processed
 //
 
-class TableItem: public QTableWidgetItem
+struct ResizeJob
 {
-  public:
-    explicit TableItem(QString text = QString());
+    int     Id;       // Caller-defined identifier of the job
+    QString Filename; // File to resize, overwritten by the resized picture
+    QSize   OrgSize;  // Size of the original picture, as probed when it was dropped
+    QSize   NewSize;  // Size of the resized picture
 };
 
-#endif // TABLEITEM_HPP
+#endif // RESIZEJOB_HPP
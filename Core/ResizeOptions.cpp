@@ -0,0 +1,77 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "ResizeOptions.hpp"
+#include <QSettings>
+
+//
+//  ResizeOptions
+//
+// Constructor. Default values are the safe ones
+//
+
+ResizeOptions::ResizeOptions()
+    : Filter(Resampler::FilterTriangle)
+    , UseEmbeddedThumbnail(true)
+    , ThumbnailQualityGuard(true)
+    , Scheduling(JobScheduler::PolicyLargestFirst)
+    , Workers(0)
+    , IoWorkers(DEFAULT_IO_WORKERS)
+    , BufferPoolSize(DEFAULT_BUFFER_POOL_SIZE)
+    , ProcessIsolation(false)
+    , Background(false)
+    , MaxLoad(DEFAULT_MAX_LOAD)
+    , ReadBandwidth(0)
+    , WriteBandwidth(0)
+    , TargetSize(0)
+    , TargetDownscale(true)
+    , ConvertToSrgb(false)
+{
+}
+
+//
+//  fromSettings
+//
+// Read the engine settings. They are not exposed in the UI, but they can be changed in the settings file.
+// Shared by the GUI and the command line
+//
+
+ResizeOptions ResizeOptions::fromSettings()
+{
+    QSettings     Settings;
+    ResizeOptions Options;
+    Options.Filter                = Resampler::filterFromName(Settings.value("Resize/Filter").toString(), Options.Filter);
+    Options.UseEmbeddedThumbnail  = Settings.value("Resize/UseEmbeddedThumbnail", Options.UseEmbeddedThumbnail).toBool();
+    Options.ThumbnailQualityGuard = Settings.value("Resize/ThumbnailQualityGuard", Options.ThumbnailQualityGuard).toBool();
+    Options.Scheduling            = JobScheduler::policyFromName(Settings.value("Resize/Scheduling").toString(), Options.Scheduling);
+    Options.Workers               = qMax(Settings.value("Resize/Workers", Options.Workers).toInt(), 0);
+    Options.IoWorkers             = qMax(Settings.value("Resize/IoWorkers", Options.IoWorkers).toInt(), 1);
+    Options.BufferPoolSize        = qMax(Settings.value("Resize/BufferPoolSize", Options.BufferPoolSize).toInt(), 0);
+    Options.ProcessIsolation      = Settings.value("Resize/ProcessIsolation", Options.ProcessIsolation).toBool();
+    Options.Background            = Settings.value("Resize/Background", Options.Background).toBool();
+    Options.MaxLoad               = qMax(Settings.value("Resize/MaxLoad", Options.MaxLoad).toDouble(), 0.0);
+    Options.ReadBandwidth         = qMax(Settings.value("Resize/ReadBandwidth", Options.ReadBandwidth).toInt(), 0);
+    Options.WriteBandwidth        = qMax(Settings.value("Resize/WriteBandwidth", Options.WriteBandwidth).toInt(), 0);
+    Options.TargetSize            = qMax(Settings.value("Resize/TargetSize", Options.TargetSize).toInt(), 0);
+    Options.TargetDownscale       = Settings.value("Resize/TargetDownscale", Options.TargetDownscale).toBool();
+    Options.ConvertToSrgb         = Settings.value("Resize/ConvertToSrgb", Options.ConvertToSrgb).toBool();
+    Options.Limits                = ImageLimits::fromSettings();
+    return Options;
+}
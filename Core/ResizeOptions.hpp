@@ -0,0 +1,88 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef RESIZEOPTIONS_HPP
+#define RESIZEOPTIONS_HPP
+
+#include "BufferPool.hpp"
+#include "ImageLimits.hpp"
+#include "JobScheduler.hpp"
+#include "Resampler.hpp"
+
+//
+//  ResizeOptions
+//
+// Engine settings of a resizing process. They don't change the new sizes, only how pictures are produced
+//
+
+struct ResizeOptions
+{
+    ResizeOptions();
+    static ResizeOptions fromSettings(); // Read the engine settings. Missing or invalid values are replaced by the default ones
+
+    Resampler::Filter    Filter;                // Filter used to resample the pictures
+    bool                 UseEmbeddedThumbnail;  // Resample from the EXIF preview of JPEG files when it's large enough for the target
+    bool                 ThumbnailQualityGuard; // Only use a preview with the picture aspect ratio, and at least twice as large as the target
+    JobScheduler::Policy Scheduling;            // Order in which the jobs are handed to the workers
+    int                  Workers;               // Number of pictures decoded and resampled in parallel. 0 means one per core
+    int                  IoWorkers;             // Number of concurrent reads and writes. Network storage needs many more than the core count
+    int                  BufferPoolSize;        // Maximum size of the recycled pixel buffers, in MB
+    bool                 ProcessIsolation;      // Resize in worker processes, so a crashing image plugin doesn't kill the program
+    bool                 Background;            // Low CPU and I/O priority, fewer workers, backing off when the machine is busy
+    double               MaxLoad;               // Background mode: load per core up to which workers are added
+    int                  ReadBandwidth;         // Maximum read bandwidth, in MB/s. 0 means unlimited
+    int                  WriteBandwidth;        // Maximum write bandwidth, in MB/s. 0 means unlimited
+    int                  TargetSize;            // Maximum size of the resized files, in KB. The best quality which fits is searched. 0 means no budget
+    bool                 TargetDownscale;       // Make the picture smaller when even the lowest quality exceeds the file size budget
+    bool                 ConvertToSrgb;         // Convert pictures with another color profile to sRGB while they are resampled
+    ImageLimits          Limits;                // Per-file limits
+};
+
+//
+//  Largest target side for which an embedded preview is looked for. Previews are never larger than that
+//
+
+#define EMBEDDED_THUMBNAIL_MAX_TARGET 1024
+
+//
+//  Default number of concurrent reads and writes. Enough to hide the latency of a NAS, harmless on a local disk
+//
+
+#define DEFAULT_IO_WORKERS 8
+
+//
+//  Default load per core up to which the background mode adds workers
+//
+
+#define DEFAULT_MAX_LOAD 1.0
+
+//
+//  Maximum number of size reductions tried to meet the file size budget
+//
+
+#define TARGET_SIZE_MAX_DOWNSCALES 4
+
+//
+//  Margin applied to the area ratio estimated from the smallest encoding, so a reduction is rarely followed by another one
+//
+
+#define TARGET_SIZE_DOWNSCALE_MARGIN 0.9
+
+#endif // RESIZEOPTIONS_HPP
@@ -0,0 +1,85 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "ResizeParameters.hpp"
+#include <QtGlobal>
+
+//
+//  ResizeParameters
+//
+// Constructor
+//
+
+ResizeParameters::ResizeParameters(ResizingMethod method, int percentage, int absolutesize)
+    : Method(method)
+    , Percentage(percentage)
+    , AbsoluteSize(absolutesize)
+{
+}
+
+//
+//  operator==
+//
+// Compare two sets of parameters
+//
+
+bool ResizeParameters::operator==(const ResizeParameters& other) const
+{
+    return (this->Method == other.Method) && (this->Percentage == other.Percentage) && (this->AbsoluteSize == other.AbsoluteSize);
+}
+
+bool ResizeParameters::operator!=(const ResizeParameters& other) const
+{
+    return !(*this == other);
+}
+
+//
+//  newSize
+//
+// Return the new size of a picture, according to the selected resizing method
+//
+
+QSize ResizeParameters::newSize(QSize orgsize) const
+{
+    QSize NewSize;
+
+    // Percentage method selected. Use 64 bits arithmetic, huge pictures would overflow
+    if (this->Method == MethodPercentage) {
+        NewSize.setWidth(int((qint64(orgsize.width()) * this->Percentage) / 100));
+        NewSize.setHeight(int((qint64(orgsize.height()) * this->Percentage) / 100));
+    }
+    // Absolute Size method selected
+    else {
+        if (orgsize.width() > orgsize.height()) {
+            NewSize.setHeight(int((qint64(orgsize.height()) * this->AbsoluteSize) / orgsize.width()));
+            NewSize.setWidth(this->AbsoluteSize);
+        }
+        else {
+            NewSize.setWidth(int((qint64(orgsize.width()) * this->AbsoluteSize) / qMax(orgsize.height(), 1)));
+            NewSize.setHeight(this->AbsoluteSize);
+        }
+    }
+
+    // Prevent from getting a null size
+    NewSize.setWidth(qMax(NewSize.width(), 1));
+    NewSize.setHeight(qMax(NewSize.height(), 1));
+
+    return NewSize;
+}
@@ -0,0 +1,51 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef RESIZEPARAMETERS_HPP
+#define RESIZEPARAMETERS_HPP
+
+#include <QSize>
+
+//
+//  ResizeParameters
+//
+// This class holds the resizing method selected by the user, and computes new picture sizes from it.
+// It's cheap to copy and to evaluate, so new sizes never need to be stored
+//
+
+class ResizeParameters
+{
+  public:
+    enum ResizingMethod {
+        MethodPercentage,   // New size is a percentage of the original size
+        MethodAbsoluteSize, // Largest side of the picture is set to a given number of pixels
+    };
+
+    ResizeParameters(ResizingMethod method = MethodPercentage, int percentage = 50, int absolutesize = 300);
+    bool  operator==(const ResizeParameters& other) const;
+    bool  operator!=(const ResizeParameters& other) const;
+    QSize newSize(QSize orgsize) const; // Compute the new dimensions of a picture
+
+    ResizingMethod Method;       // Selected resizing method
+    int            Percentage;   // Value used by the percentage method
+    int            AbsoluteSize; // Value used by the absolute size method
+};
+
+#endif // RESIZEPARAMETERS_HPP
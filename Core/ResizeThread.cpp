@@ -19,10 +19,40 @@
  */
 
 #include "ResizeThread.hpp"
-#include <QImage>
+#include "BufferPool.hpp"
+#include "JobJournal.hpp"
+#include "ResizeEngine.hpp"
+#include "ResourceGovernor.hpp"
+#include "StageMetrics.hpp"
+#include "TraceRecorder.hpp"
+#include "WorkerProcess.hpp"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QEventLoop>
+#include <QHash>
+#include <QMutexLocker>
+#include <QProcess>
+#include <QSemaphore>
+#include <QSettings>
+#include <QSharedPointer>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+#include <climits>
 
 ResizeThread* ResizeThread::resizethread = nullptr;
 
+ResizeThread::ResizeThread()
+    : CpuWorkers(1)
+    , IoWorkers(1)
+    , NextJob(0)
+    , InputClosed(true)
+    , Accepting(false)
+{
+}
+
 ResizeThread* ResizeThread::instance()
 {
     if (resizethread == nullptr) {
@@ -39,44 +69,162 @@ void ResizeThread::release()
     }
 }
 
-void ResizeThread::resize(QList<QPair<QString, QSize>> files)
+//
+//  resize
+//
+// Start a resizing process. In streaming mode, more jobs may be enqueued while it runs, until closeInput() is called.
+// The previous process may still be returning from run() when its termination signal is handled: wait for it
+//
+
+void ResizeThread::resize(QList<ResizeJob> jobs, ResizeOptions options, bool streaming)
 {
-    this->Files = files;
+    wait();
+    this->Options = options;
+
+    // Size the pools. The number of jobs of a streaming process is unknown.
+    // The background mode leaves cores and disk bandwidth to the interactive programs
+    int Bound      = streaming ? INT_MAX : qMax(jobs.count(), 1);
+    int CpuWorkers = this->Options.Workers > 0 ? this->Options.Workers : QThread::idealThreadCount();
+    int IoWorkers  = this->Options.IoWorkers;
+    if (this->Options.Background) {
+        CpuWorkers = qMin(CpuWorkers, qMax(1, QThread::idealThreadCount() / BACKGROUND_WORKERS_DIVISOR));
+        IoWorkers  = qMin(IoWorkers, BACKGROUND_IO_WORKERS);
+    }
+    this->CpuWorkers = qBound(1, CpuWorkers, Bound);
+    this->IoWorkers  = qBound(1, IoWorkers, Bound);
+
+    // Order the jobs. Predictions use the cost coefficient measured during the previous process
+    QSettings Settings;
+    this->Scheduler.reset(this->Options.Scheduling, this->CpuWorkers, Settings.value("Scheduler/NsPerPixel", DEFAULT_NS_PER_PIXEL).toDouble());
+    this->Scheduler.append(jobs);
+
+    this->MutexJobs.lock();
+    this->NextJob     = 0;
+    this->InputClosed = !streaming;
+    this->Accepting   = true;
+    this->Unplanned   = jobs;
+    this->MutexJobs.unlock();
+
     start();
 }
 
-void ResizeThread::run()
-{
-    // Clear the list of files that we failed to resize
-    this->InvalidFiles.clear();
+//
+//  enqueue
+//
+// Add jobs to a running streaming process. Return false if the process has stopped accepting jobs because it's terminating:
+// the caller must start a new process once the termination signal is received.
+// The jobs are journaled by the process, so the UI doesn't wait for the disk
+//
 
-    // Resize images
-    for (int i = 0; i < this->Files.count(); i++) {
-        QPair<QString, QSize> File = this->Files.at(i);
+bool ResizeThread::enqueue(QList<ResizeJob> jobs)
+{
+    QMutexLocker Locker(&this->MutexJobs);
+    if (!this->Accepting) {
+        return false;
+    }
 
-        // Read data, and emit a signal to UI
-        QString Filename = File.first;
-        QSize   Size     = File.second;
-        emit resizingFile(Filename);
+    this->Scheduler.append(jobs);
+    this->Unplanned << jobs;
+    this->JobsAvailable.wakeAll();
+    return true;
+}
 
-        // Open image
-        QImage Image(Filename);
+//
+//  closeInput
+//
+// Tell a streaming process that no more jobs are expected. It terminates once the queued jobs are done,
+// unless new jobs are enqueued before
+//
 
-        // Resize the image
-        QImage ResizedImage = Image.scaled(Size.width(), Size.height(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-        if (ResizedImage.isNull() || !ResizedImage.save(Filename)) {
-            this->InvalidFiles << Filename;
-        }
+void ResizeThread::closeInput()
+{
+    QMutexLocker Locker(&this->MutexJobs);
+    this->InputClosed = true;
+    this->JobsAvailable.wakeAll();
+}
 
-        // Tell the UI that a file has been processed
-        emit fileResized();
+//
+//  takeJob
+//
+// Give the position of the next job to a worker. If wait is true, wait until a job is enqueued or the input is closed.
+// Return false if there is no job to take. Once the queue is empty and the input is closed, the process stops accepting jobs.
+// The queued jobs are journaled before any of them is given, as the scheduler may reorder them. The journal is written
+// without the lock, so the UI enqueueing more jobs doesn't wait for it
+//
 
-        // Terminate if cancellaation has been requested
+bool ResizeThread::takeJob(int* index, bool wait)
+{
+    QMutexLocker Locker(&this->MutexJobs);
+    while (this->Accepting) {
         if (isInterruptionRequested()) {
-            break;
+            this->Accepting = false;
+        }
+        else if (!this->Unplanned.isEmpty()) {
+            QList<ResizeJob> Jobs;
+            Jobs.swap(this->Unplanned);
+            Locker.unlock();
+            JobJournal::instance()->plan(Jobs);
+            Locker.relock();
+        }
+        else if (this->NextJob < this->Scheduler.count()) {
+            *index = this->NextJob++;
+            return true;
+        }
+        else if (this->InputClosed) {
+            this->Accepting = false;
         }
+        else if (!wait) {
+            return false;
+        }
+        else {
+            // Cancellation doesn't wake the condition: wake up regularly to check it
+            this->JobsAvailable.wait(&this->MutexJobs, WORKER_POLLING_INTERVAL);
+        }
+    }
+    return false;
+}
+
+//
+//  isInputExhausted
+//
+// Return true once the process has stopped accepting jobs: all jobs have been taken, and no more will come
+//
+
+bool ResizeThread::isInputExhausted() const
+{
+    QMutexLocker Locker(&this->MutexJobs);
+    return !this->Accepting;
+}
+
+//
+//  run
+//
+// Resize the jobs in the worker pools, or in worker processes if the pictures are not trusted
+//
+
+void ResizeThread::run()
+{
+    // Clear the list of files that we failed to resize
+    this->Errors.clear();
+    if (this->Options.Background) {
+        ResourceGovernor::lowerCurrentThread();
     }
 
+    QElapsedTimer Timer;
+    Timer.start();
+    if (this->Options.ProcessIsolation) {
+        runProcesses(this->CpuWorkers, Timer);
+    }
+    else {
+        runPipeline(this->CpuWorkers, this->IoWorkers, Timer);
+    }
+
+    this->Scheduler.setElapsed(Timer.nsecsElapsed());
+    saveSchedulingReport();
+    saveMetricsReport();
+    ErrorLog::flushLogFile();
+    JobJournal::instance()->finish();
+
     // Tell the UI that process is terminated
     if (isInterruptionRequested()) {
         emit resizingAborted();
@@ -86,7 +234,412 @@ void ResizeThread::run()
     }
 }
 
-QStringList ResizeThread::invalidFiles() const
+//
+//  runPipeline
+//
+// Feed the pipeline. Reads and writes are latency-bound on network storage, so they run in their own pool, which can be much
+// larger than the number of cores. Decoding, resampling and encoding run in the CPU pool, one thread per core by default.
+// The number of jobs in flight is bounded, so file contents don't pile up in memory when one stage is faster than the other
+//
+
+void ResizeThread::runPipeline(int cpuworkers, int ioworkers, const QElapsedTimer& timer)
+{
+    // Pixel buffers are recycled between pictures
+    BufferPool::instance()->setCapacity(qint64(this->Options.BufferPoolSize) * 1024 * 1024);
+
+    ResizeEngine Engine(this->Options);
+    QThreadPool  IoPool;
+    QThreadPool  CpuPool;
+    int          InFlight = ioworkers + 2 * cpuworkers;
+    QSemaphore   Slots(InFlight);
+    IoPool.setMaxThreadCount(ioworkers);
+    CpuPool.setMaxThreadCount(cpuworkers);
+
+    // In background mode, the size of the CPU pool follows the load of the machine. It's checked between two jobs
+    QElapsedTimer LoadTimer;
+    LoadTimer.start();
+
+    // Wait for a free slot, then for a job. In streaming mode, jobs are resized as soon as they are enqueued.
+    // The wait is traced, so the timeline shows whether the pipeline is full or starved
+    for (int Index = 0;;) {
+        if (this->Options.Background && (LoadTimer.elapsed() >= BACKGROUND_LOAD_INTERVAL)) {
+            LoadTimer.restart();
+            int Workers = ResourceGovernor::adaptWorkers(CpuPool.maxThreadCount(), cpuworkers, this->Options.MaxLoad);
+            if (Workers != CpuPool.maxThreadCount()) {
+                qInfo().noquote() << QString("Background mode: load average %1, %2 CPU workers").arg(ResourceGovernor::loadAverage(), 0, 'f', 2).arg(Workers);
+                CpuPool.setMaxThreadCount(Workers);
+            }
+        }
+
+        TraceScope Wait("wait", -1);
+        Slots.acquire();
+        if (!takeJob(&Index, true)) {
+            Slots.release();
+            break;
+        }
+        Wait.finish();
+
+        QSharedPointer<ResizeTask> Task(new ResizeTask);
+        Task->Index   = Index;
+        Task->Job     = this->Scheduler.job(Index);
+        Task->Preview = false;
+        Task->Failure = ErrorRecords::ReasonNone;
+        Task->Start   = 0;
+        Task->Elapsed = 0;
+
+        // Read, then hand the task to the CPU pool, which hands it back to the I/O pool to write the result.
+        // The timeout is checked after each stage, so a slow file doesn't go further. The decoder is also stopped by the engine
+        // when it exceeds the timeout. The job starts when it's read, and its duration is the time spent in its stages:
+        // the waits in the pool queues depend on the load, not on the picture, and would skew the calibration of the scheduler
+        IoPool.start([this, Task, &Engine, &IoPool, &CpuPool, &Slots, &timer]() {
+            if (this->Options.Background) {
+                ResourceGovernor::lowerCurrentThread();
+            }
+            emit resizingFile(Task->Job.Id, Task->Job.Filename);
+            Task->Start = timer.nsecsElapsed();
+            bool Success = Engine.read(*Task);
+            Task->Elapsed += timer.nsecsElapsed() - Task->Start;
+            if (!Success || this->Options.Limits.isTimedOut(Task->Elapsed)) {
+                finishJob(Task->Index, Task->Job, Task->Start, Task->Elapsed, Success ? ErrorRecords::ReasonTimeout : Task->Failure, ErrorRecords::StageRead);
+                Slots.release();
+                return;
+            }
+            CpuPool.start([this, Task, &Engine, &IoPool, &Slots, &timer]() {
+                if (this->Options.Background) {
+                    ResourceGovernor::lowerCurrentThread();
+                }
+                qint64 StageStart = timer.nsecsElapsed();
+                bool   Success    = Engine.process(*Task);
+                Task->Elapsed += timer.nsecsElapsed() - StageStart;
+                if (!Success || this->Options.Limits.isTimedOut(Task->Elapsed)) {
+                    finishJob(Task->Index, Task->Job, Task->Start, Task->Elapsed, Success ? ErrorRecords::ReasonTimeout : Task->Failure, ErrorRecords::StageProcess);
+                    Slots.release();
+                    return;
+                }
+                IoPool.start([this, Task, &Engine, &Slots, &timer]() {
+                    if (this->Options.Background) {
+                        ResourceGovernor::lowerCurrentThread();
+                    }
+                    qint64 StageStart = timer.nsecsElapsed();
+                    Engine.write(*Task);
+                    Task->Elapsed += timer.nsecsElapsed() - StageStart;
+                    Task->Data.clear();
+                    finishJob(Task->Index, Task->Job, Task->Start, Task->Elapsed, Task->Failure, ErrorRecords::StageWrite);
+                    Slots.release();
+                });
+            });
+        });
+    }
+
+    // Wait for the jobs in flight. Every slot is given back by the last stage of a job
+    Slots.acquire(InFlight);
+    IoPool.waitForDone();
+    CpuPool.waitForDone();
+
+    // Don't keep hundreds of MB once the process is over
+    BufferPool::instance()->clear();
+}
+
+//
+//  runProcesses
+//
+// Resize the pictures in worker processes, so a crash of an image plugin only kills a worker.
+// Each worker receives at most two jobs at a time: the one it processes, and the next one, so it never waits for the main program.
+// When a worker dies, the file it was processing is recorded as invalid, the jobs it had not started are given back
+// to the queue, and the worker is restarted. A worker which keeps failing without processing a file is given up
+//
+
+void ResizeThread::runProcesses(int workers, const QElapsedTimer& timer)
+{
+    struct Worker
+    {
+        QProcess*  Process;  // Worker process
+        QList<int> Sent;     // Queue indexes of the jobs sent to the worker and not finished yet
+        int        Running;  // Queue index of the job being processed, -1 if none
+        QByteArray Output;   // Incomplete line received from the worker
+        int        Failures; // Number of failures in a row
+        bool       TimedOut; // True if the worker has been killed because it exceeded the timeout
+        bool       Stopped;  // True once the worker won't be restarted
+    };
+
+    QEventLoop         Loop;
+    QTimer             PollingTimer;
+    QList<int>         Requeued; // Queue indexes of the jobs given back by the workers which died
+    QHash<int, qint64> Starts;   // Start time of the jobs, by queue index
+    QVector<Worker>    Workers(workers);
+    QString            Program   = QCoreApplication::applicationFilePath();
+    QStringList        Arguments = WorkerProcess::arguments(this->Options, workers);
+
+    // Send jobs to a worker until it has two of them. Close its input once there's nothing more to do, so it exits
+    auto feed = [&](int w) {
+        Worker& Current = Workers[w];
+        if (Current.Stopped || (Current.Process->state() == QProcess::NotRunning)) {
+            return;
+        }
+        while ((Current.Sent.count() < 2) && !isInterruptionRequested()) {
+            int Index = 0;
+            if (!Requeued.isEmpty()) {
+                Index = Requeued.takeFirst();
+            }
+            else if (!takeJob(&Index, false)) {
+                break;
+            }
+            Current.Sent << Index;
+            Current.Process->write(WorkerProcess::encodeJob(this->Scheduler.job(Index)));
+        }
+        if (Current.Sent.isEmpty() && (isInterruptionRequested() || (Requeued.isEmpty() && isInputExhausted()))) {
+            Current.Process->closeWriteChannel();
+        }
+    };
+
+    // Quit the loop once all workers are stopped. Jobs which couldn't be sent to anybody are failed,
+    // and a streaming process stops accepting new ones
+    auto checkTermination = [&]() {
+        for (const Worker& Current : Workers) {
+            if (!Current.Stopped) {
+                return;
+            }
+        }
+        if (!isInterruptionRequested()) {
+            closeInput();
+            for (int Index = 0; !Requeued.isEmpty() || takeJob(&Index, false);) {
+                if (!Requeued.isEmpty()) {
+                    Index = Requeued.takeFirst();
+                }
+                ResizeJob Job = this->Scheduler.job(Index);
+                emit resizingFile(Job.Id, Job.Filename);
+                finishJob(Index, Job, timer.nsecsElapsed(), 0, ErrorRecords::ReasonNotProcessed, ErrorRecords::StageQueue);
+            }
+        }
+        Loop.quit();
+    };
+
+    // A worker has exited or couldn't start. Fail the file it was processing, give its other jobs back, and restart it if needed
+    auto onWorkerEnded = [&](int w, bool crashed) {
+        Worker& Current = Workers[w];
+        if (Current.Running != -1) {
+            int Index = Current.Running;
+            qWarning().noquote() << (Current.TimedOut ? "Worker process killed after timeout while resizing" : "Worker process crashed while resizing")
+                                 << this->Scheduler.job(Index).Filename;
+            Current.Sent.removeOne(Index);
+            finishJob(Index,
+                      this->Scheduler.job(Index),
+                      Starts.value(Index),
+                      timer.nsecsElapsed() - Starts.value(Index),
+                      Current.TimedOut ? ErrorRecords::ReasonTimeout : ErrorRecords::ReasonCrashed,
+                      ErrorRecords::StageProcess);
+            Current.Running  = -1;
+            Current.Failures = 0;
+            Current.TimedOut = false;
+        }
+        else if (crashed) {
+            Current.Failures++;
+        }
+        while (!Current.Sent.isEmpty()) {
+            Requeued.prepend(Current.Sent.takeLast());
+        }
+        Current.Output.clear();
+
+        if ((Requeued.isEmpty() && isInputExhausted()) || isInterruptionRequested() || (Current.Failures >= WORKER_MAX_FAILURES)) {
+            Current.Stopped = true;
+            checkTermination();
+        }
+        else {
+            QTimer::singleShot(0, &Loop, [&, w]() {
+                Workers[w].Process->start(Program, Arguments);
+                feed(w);
+            });
+        }
+    };
+
+    // Parse the lines written by a worker
+    auto onWorkerOutput = [&](int w) {
+        Worker& Current = Workers[w];
+        Current.Output += Current.Process->readAllStandardOutput();
+        for (int End = Current.Output.indexOf('\n'); End != -1; End = Current.Output.indexOf('\n')) {
+            QList<QByteArray> Fields = Current.Output.left(End).split('\t');
+            Current.Output.remove(0, End + 1);
+
+            int Index = -1;
+            for (int Sent : Current.Sent) {
+                if ((Fields.count() >= 2) && (this->Scheduler.job(Sent).Id == Fields.at(1).toInt())) {
+                    Index = Sent;
+                }
+            }
+            if (Index == -1) {
+                continue;
+            }
+
+            if (Fields.at(0) == "S") {
+                Current.Running = Index;
+                Starts[Index]   = timer.nsecsElapsed();
+                emit resizingFile(this->Scheduler.job(Index).Id, this->Scheduler.job(Index).Filename);
+            }
+            else if ((Fields.at(0) == "M") && (Fields.count() == 6)) {
+                int Stage = Fields.at(2).toInt();
+                if ((Stage >= 0) && (Stage < StageStatistics::StageCount)) {
+                    StageMetrics::instance()->record(StageStatistics::Stage(Stage), Fields.at(3).toLongLong(), Fields.at(4).toLongLong(), Fields.at(5).toLongLong());
+                }
+            }
+            else if ((Fields.at(0) == "D") && (Fields.count() == 4)) {
+                int Reason       = Fields.at(2).toInt();
+                int Stage        = Fields.at(3).toInt();
+                Current.Running  = -1;
+                Current.Failures = 0;
+                Current.Sent.removeOne(Index);
+                finishJob(Index,
+                          this->Scheduler.job(Index),
+                          Starts.value(Index),
+                          timer.nsecsElapsed() - Starts.value(Index),
+                          ((Reason >= 0) && (Reason < ErrorRecords::ReasonCount)) ? ErrorRecords::Reason(Reason) : ErrorRecords::ReasonCrashed,
+                          ((Stage >= 0) && (Stage <= ErrorRecords::StageQueue)) ? ErrorRecords::Stage(Stage) : ErrorRecords::StageProcess);
+            }
+        }
+        feed(w);
+    };
+
+    // Start the workers
+    for (int w = 0; w < workers; w++) {
+        Worker& Current  = Workers[w];
+        Current.Process  = new QProcess;
+        Current.Running  = -1;
+        Current.Failures = 0;
+        Current.TimedOut = false;
+        Current.Stopped  = false;
+        Current.Process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+        QObject::connect(Current.Process, &QProcess::readyReadStandardOutput, [&, w]() { onWorkerOutput(w); });
+        QObject::connect(Current.Process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), [&, w](int exitcode, QProcess::ExitStatus exitstatus) {
+            onWorkerOutput(w);
+            onWorkerEnded(w, (exitstatus == QProcess::CrashExit) || (exitcode != 0));
+        });
+        QObject::connect(Current.Process, &QProcess::errorOccurred, [&, w](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) {
+                onWorkerEnded(w, true);
+            }
+        });
+    }
+
+    // Kill the workers stuck on a file for too long, and give the jobs enqueued in streaming mode to idle workers.
+    // Once cancellation is requested, no more jobs are sent: workers finish the files they have received, then exit
+    QObject::connect(&PollingTimer, &QTimer::timeout, [&]() {
+        for (int w = 0; w < workers; w++) {
+            Worker& Current = Workers[w];
+            if ((Current.Running != -1) && !Current.TimedOut && this->Options.Limits.isTimedOut(timer.nsecsElapsed() - Starts.value(Current.Running))) {
+                Current.TimedOut = true;
+                Current.Process->kill();
+            }
+            feed(w);
+        }
+    });
+    PollingTimer.start(WORKER_POLLING_INTERVAL);
+
+    for (int w = 0; w < workers; w++) {
+        Workers[w].Process->start(Program, Arguments);
+        feed(w);
+    }
+
+    Loop.exec();
+
+    for (Worker& Current : Workers) {
+        Current.Process->disconnect();
+        Current.Process->waitForFinished();
+        delete Current.Process;
+    }
+}
+
+//
+//  finishJob
+//
+// Last stage of a job, whatever its result. Record its start and the time spent processing it, the failure if any
+// and the completion in the journal, then tell the UI
+//
+
+void ResizeThread::finishJob(int index, const ResizeJob& job, qint64 startns, qint64 durationns, ErrorRecords::Reason reason, ErrorRecords::Stage stage)
+{
+    this->Scheduler.recordJob(index, startns, durationns);
+    if (reason != ErrorRecords::ReasonNone) {
+        this->Errors.append(job.Filename, stage, reason);
+    }
+
+    // A job which couldn't be given to a worker stays in the journal, so it's resumed next time
+    if (reason != ErrorRecords::ReasonNotProcessed) {
+        JobJournal::instance()->complete(job.Id);
+    }
+
+    // Tell the UI that a file has been processed
+    emit fileResized(job.Id, reason == ErrorRecords::ReasonNone);
+}
+
+//
+//  saveSchedulingReport
+//
+// Log the predicted vs. actual runtime report, write the per-job measures in the application data directory,
+// and keep the measured cost coefficient for the next process
+//
+
+void ResizeThread::saveSchedulingReport()
+{
+    this->SchedulingReport = this->Scheduler.report();
+    qInfo().noquote() << this->SchedulingReport;
+
+    QString Directory = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (!Directory.isEmpty() && QDir().mkpath(Directory)) {
+        this->Scheduler.writeCsv(Directory + "/scheduling.csv");
+    }
+
+    QSettings Settings;
+    Settings.setValue("Scheduler/NsPerPixel", this->Scheduler.calibratedNsPerPixel());
+}
+
+//
+//  saveMetricsReport
+//
+// Take the stage measures collected during the process (and the probes of the files dropped since the previous one),
+// log them, and write them as JSON and CSV in the application data directory
+//
+
+void ResizeThread::saveMetricsReport()
+{
+    this->Metrics = StageMetrics::instance()->take();
+    qInfo().noquote() << this->Metrics.summary();
+
+    QString Directory = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (!Directory.isEmpty() && QDir().mkpath(Directory)) {
+        this->Metrics.write(Directory + "/metrics.json");
+        this->Metrics.write(Directory + "/metrics.csv");
+    }
+}
+
+//
+//  errors
+//
+// Return the files which couldn't be resized during the last process, with the stage and the reason of the failure
+//
+
+ErrorRecords ResizeThread::errors() const
+{
+    return this->Errors.records();
+}
+
+//
+//  schedulingReport
+//
+// Return the scheduling report of the last process: predicted runtimes compared with the measured ones
+//
+
+QString ResizeThread::schedulingReport() const
+{
+    return this->SchedulingReport;
+}
+
+//
+//  metrics
+//
+// Return the stage measures of the last process
+//
+
+StageStatistics ResizeThread::metrics() const
 {
-    return this->InvalidFiles;
+    return this->Metrics;
 }
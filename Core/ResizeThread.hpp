@@ -21,34 +21,66 @@
 #ifndef RESIZETHREAD_HPP
 #define RESIZETHREAD_HPP
 
+#include "ErrorLog.hpp"
+#include "JobScheduler.hpp"
+#include "ResizeJob.hpp"
+#include "ResizeOptions.hpp"
+#include "StageMetrics.hpp"
+#include <QImage>
 #include <QList>
-#include <QPair>
-#include <QSize>
+#include <QElapsedTimer>
+#include <QMutex>
 #include <QString>
+#include <QStringList>
 #include <QThread>
+#include <QWaitCondition>
 
 class ResizeThread: public QThread
 {
     Q_OBJECT
 
   public:
-    static ResizeThread* instance();                                 // Return a pointer to the object instance. Create the instance if needed
-    static void          release();                                  // Delete the thread if it was created
-    void                 resize(QList<QPair<QString, QSize>> files); // Called when the Resize button is clicked
-    QStringList          invalidFiles() const;
+    static ResizeThread* instance();                                                                   // Return a pointer to the object instance. Create the instance if needed
+    static void          release();                                                                    // Delete the thread if it was created
+    void                 resize(QList<ResizeJob> jobs, ResizeOptions options, bool streaming = false); // Start a resizing process. In streaming mode, more jobs may be enqueued until closeInput() is called
+    bool                 enqueue(QList<ResizeJob> jobs);                                               // Add jobs to a running streaming process. Return false if the process doesn't accept jobs anymore
+    void                 closeInput();                                                                 // Tell a streaming process that no more jobs will be enqueued
+    ErrorRecords         errors() const;                                                               // Return the files which couldn't be resized, with the stage and the reason
+    QString              schedulingReport() const;                                                     // Return the predicted vs. actual runtime report of the last process
+    StageStatistics      metrics() const;                                                              // Return the stage measures of the last process
 
   private:
-    static ResizeThread* resizethread;   // Singleton instance pointer
-    void                 run() override; // Thread worker
+    ResizeThread();
 
-    QList<QPair<QString, QSize>> Files;        // Contain a description of the files that have to be resized
-    QStringList                  InvalidFiles; // Contain the list of the files which couldn't be resized
+    static ResizeThread* resizethread;                                                                                                                     // Singleton instance pointer
+    void                 run() override;                                                                                                                   // Thread worker
+    bool                 takeJob(int* index, bool wait);                                                                                                   // Give the queue index of the next job to a worker. Return false if there is none
+    bool                 isInputExhausted() const;                                                                                                         // Return true once all jobs have been taken and no more will be enqueued
+    void                 runPipeline(int cpuworkers, int ioworkers, const QElapsedTimer& timer);                                                           // Resize in the I/O and CPU thread pools
+    void                 runProcesses(int workers, const QElapsedTimer& timer);                                                                            // Resize in worker processes
+    void                 finishJob(int index, const ResizeJob& job, qint64 startns, qint64 durationns, ErrorRecords::Reason reason, ErrorRecords::Stage stage); // Record the result of a job and tell the UI
+    void                 saveSchedulingReport();                                                                                                           // Log the scheduling report, and keep the measured cost coefficient for the next process
+    void                 saveMetricsReport();                                                                                                              // Take, log and save the stage measures of the process
+
+    ResizeOptions    Options;          // Engine settings of the current process
+    int              CpuWorkers;       // Size of the CPU pool, or number of worker processes
+    int              IoWorkers;        // Size of the I/O pool
+    ErrorLog         Errors;           // Files which couldn't be resized, filled by the workers
+    JobScheduler     Scheduler;        // Order the jobs and measure their runtime
+    QString          SchedulingReport; // Report of the last process
+    StageStatistics  Metrics;          // Stage measures of the last process
+    mutable QMutex   MutexJobs;        // Protect the queue state below, shared by the UI and the workers
+    QWaitCondition   JobsAvailable;    // Wake the pipeline up when jobs are enqueued or the input is closed
+    int              NextJob;          // Queue index of the next job to give to a worker
+    bool             InputClosed;      // True once no more jobs will be enqueued
+    bool             Accepting;        // False once the queue is exhausted and closed, or the process interrupted: enqueue() is refused
+    QList<ResizeJob> Unplanned;        // Jobs queued but not journaled yet. They are journaled by the process before one of them starts
 
   signals:
-    void resizingFile(QString filename); // Emitted the name of the file whose resizing process starts
-    void fileResized();                  // Emitted when a file resizing is terminated (successfully or not)
-    void resizingTerminated();           // Emitted when all files have been resized-+
-    void resizingAborted();              // Emitted if resizing process is aborted
+    void resizingFile(int id, QString filename); // Emitted the id and name of the file whose resizing process starts
+    void fileResized(int id, bool success);      // Emitted when a file resizing is terminated (successfully or not)
+    void resizingTerminated();                   // Emitted when all files have been resized
+    void resizingAborted();                      // Emitted if resizing process is aborted
 };
 
 #endif // RESIZETHREAD_HPP
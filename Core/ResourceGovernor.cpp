@@ -0,0 +1,179 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "ResourceGovernor.hpp"
+#include <QMutexLocker>
+#include <QThread>
+#include <cmath>
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <cstdlib>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#if defined(Q_OS_LINUX)
+#include <sys/syscall.h>
+#endif
+
+#if defined(Q_OS_LINUX)
+//
+//  Linux I/O priority, from linux/ioprio.h, which is not exposed by the C library
+//
+
+#define IOPRIO_WHO_PROCESS 1
+#define IOPRIO_CLASS_BE 2
+#define IOPRIO_CLASS_SHIFT 13
+#define IOPRIO_LOWEST_LEVEL 7
+#endif
+
+namespace {
+    thread_local bool Lowered = false; // True once the calling thread has been given a low priority
+} // namespace
+
+//
+//  TokenBucket
+//
+// Constructor. The bandwidth is unlimited
+//
+
+TokenBucket::TokenBucket()
+    : Rate(0)
+    , Tokens(0)
+    , Last(0)
+{
+    this->Clock.start();
+}
+
+//
+//  setRate
+//
+// Set the bandwidth, in bytes per second. The bucket starts full
+//
+
+void TokenBucket::setRate(qint64 bytespersecond)
+{
+    QMutexLocker Locker(&this->Mutex);
+    this->Rate   = qMax(bytespersecond, qint64(0));
+    this->Tokens = this->Rate;
+    this->Last   = this->Clock.nsecsElapsed();
+}
+
+//
+//  consume
+//
+// Refill the bucket with the tokens earned since the last call, take the bytes, then sleep until the debt is paid.
+// Concurrent consumers queue up: each one waits for the bytes taken before its own
+//
+
+void TokenBucket::consume(qint64 bytes)
+{
+    if (this->Rate == 0) {
+        return;
+    }
+
+    qint64 Wait = 0;
+    {
+        QMutexLocker Locker(&this->Mutex);
+        qint64       Now = this->Clock.nsecsElapsed();
+        this->Tokens     = qMin(double(this->Rate), this->Tokens + (Now - this->Last) * double(this->Rate) / 1e9);
+        this->Last       = Now;
+        this->Tokens    -= bytes;
+        if (this->Tokens < 0) {
+            Wait = qint64(std::ceil(-this->Tokens * 1000 / this->Rate));
+        }
+    }
+
+    if (Wait > 0) {
+        QThread::msleep(Wait);
+    }
+}
+
+//
+//  lowerCurrentThread
+//
+// Give the calling thread a low CPU and I/O priority:
+//   - Linux: nice value, and the lowest best-effort I/O level. The idle I/O class is not used, it could starve the batch
+//   - Windows: background mode, which lowers both priorities
+//   - macOS: background policy of Darwin, which lowers both priorities
+// Pool threads are created by each resizing process and die with it, so the priority doesn't leak to another process
+//
+
+void ResourceGovernor::lowerCurrentThread()
+{
+    if (Lowered) {
+        return;
+    }
+    Lowered = true;
+
+#if defined(Q_OS_LINUX)
+    pid_t Thread = pid_t(syscall(SYS_gettid));
+    setpriority(PRIO_PROCESS, id_t(Thread), BACKGROUND_NICE);
+    syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, Thread, (IOPRIO_CLASS_BE << IOPRIO_CLASS_SHIFT) | IOPRIO_LOWEST_LEVEL);
+#elif defined(Q_OS_WIN)
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#elif defined(Q_OS_MACOS)
+    setpriority(PRIO_DARWIN_THREAD, 0, PRIO_DARWIN_BG);
+#endif
+}
+
+//
+//  loadAverage
+//
+// Load average of the system over the last minute: the number of threads running or waiting for a core (and on Linux, for a disk).
+// Unknown on Windows
+//
+
+double ResourceGovernor::loadAverage()
+{
+#if defined(Q_OS_UNIX)
+    double Load = 0;
+    if (getloadavg(&Load, 1) == 1) {
+        return Load;
+    }
+#endif
+    return -1;
+}
+
+//
+//  adaptWorkers
+//
+// Return the CPU worker count to use. The busy workers are part of the load average, so the load of the other programs
+// is what remains once they are subtracted. The workers may use the cores left idle by the other programs, up to maxload per core.
+// The count moves one step at a time, as the load average reacts slowly to its changes. It stays between 1 and maximum
+//
+
+int ResourceGovernor::adaptWorkers(int current, int maximum, double maxload)
+{
+    double Load = loadAverage();
+    if (Load < 0) {
+        return current;
+    }
+
+    double Others = qMax(0.0, Load - current);
+    int    Target = qBound(1, int(QThread::idealThreadCount() * maxload - Others), maximum);
+    if (Target > current) {
+        return current + 1;
+    }
+    if (Target < current) {
+        return current - 1;
+    }
+    return current;
+}
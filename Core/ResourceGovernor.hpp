@@ -0,0 +1,89 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef RESOURCEGOVERNOR_HPP
+#define RESOURCEGOVERNOR_HPP
+
+#include <QElapsedTimer>
+#include <QMutex>
+
+//
+//  TokenBucket
+//
+// This class caps a bandwidth shared by several threads. Tokens are bytes, refilled at the given rate, up to one second of burst.
+// A consumer takes its bytes even if the bucket is empty, then sleeps until its debt is paid, so large files are not starved.
+// Thread-safe
+//
+
+class TokenBucket
+{
+  public:
+    TokenBucket();
+    void setRate(qint64 bytespersecond); // Set the bandwidth. 0 means unlimited. Must be called before the consumers start
+    void consume(qint64 bytes);          // Take some bytes, and sleep if the bandwidth has been exceeded
+
+  private:
+    QMutex        Mutex;  // Protect the state below
+    QElapsedTimer Clock;  // Time reference of the refills
+    qint64        Rate;   // Bandwidth in bytes per second, 0 if unlimited
+    double        Tokens; // Bytes available. Negative when consumers are in debt
+    qint64        Last;   // Time of the last refill, in ns
+};
+
+//
+//  ResourceGovernor
+//
+// This class holds the tools of the background mode, which lets a batch run on a shared workstation without making it unusable:
+// lower CPU and I/O priority of the worker threads, and a CPU worker count following the load of the machine
+//
+
+class ResourceGovernor
+{
+  public:
+    static void   lowerCurrentThread();                                   // Give the calling thread a low CPU and I/O priority. Done once per thread
+    static double loadAverage();                                          // Load average of the system over the last minute, -1 if unknown
+    static int    adaptWorkers(int current, int maximum, double maxload); // CPU worker count to use, depending on the load of the other programs
+};
+
+//
+//  Number of CPU workers used by the background mode, relative to the core count
+//
+
+#define BACKGROUND_WORKERS_DIVISOR 2
+
+//
+//  Maximum number of concurrent reads and writes in background mode
+//
+
+#define BACKGROUND_IO_WORKERS 2
+
+//
+//  Nice value of the workers in background mode (Unix)
+//
+
+#define BACKGROUND_NICE 10
+
+//
+//  Interval between two checks of the system load in background mode, in ms. The load average is updated every 5 s on Linux
+//
+
+#define BACKGROUND_LOAD_INTERVAL 5000
+
+#endif // RESOURCEGOVERNOR_HPP
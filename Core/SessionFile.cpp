@@ -0,0 +1,232 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "SessionFile.hpp"
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QSize>
+#include <QStringList>
+#include <cstring>
+
+static_assert(sizeof(SessionHeader) == 56, "The session header must keep its layout");
+
+namespace {
+    //
+    //  aligned
+    //
+    // Size of a section, padded to 8 bytes
+    //
+
+    quint64 aligned(quint64 size)
+    {
+        return (size + 7) & ~quint64(7);
+    }
+} // namespace
+
+//
+//  save
+//
+// Save the live files of a store, in the given order. Only the directories used by these files are written,
+// and the name pool is rebuilt without the names of the removed files.
+// The file is written under a temporary name, then renamed, so a failure never leaves a truncated session
+//
+
+bool SessionFile::save(const QString& filename, const FileStore& store, const QVector<quint32>& ids, const ResizeParameters& parameters, QString* error)
+{
+    QHash<int, quint32> DirectoryMap; // Store directory index -> session directory index
+    QVector<quint32>    DirectoryLengths;
+    QString             Directories;
+    QVector<quint32>    DirectoryIds;
+    QVector<quint32>    NameOffsets;
+    QVector<quint16>    NameLengths;
+    QVector<qint32>     Sizes;
+    QString             Names;
+    DirectoryIds.reserve(ids.count());
+    NameOffsets.reserve(ids.count());
+    NameLengths.reserve(ids.count());
+    Sizes.reserve(2 * ids.count());
+
+    for (quint32 Id : ids) {
+        if (store.isReleased(Id)) {
+            continue;
+        }
+
+        auto Directory = DirectoryMap.constFind(store.directoryId(Id));
+        if (Directory == DirectoryMap.constEnd()) {
+            QString Path = store.directory(Id);
+            Directory    = DirectoryMap.insert(store.directoryId(Id), quint32(DirectoryLengths.count()));
+            DirectoryLengths << quint32(Path.size());
+            Directories += Path;
+        }
+
+        QString Name = store.name(Id);
+        QSize   Size = store.orgSize(Id);
+        DirectoryIds << Directory.value();
+        NameOffsets << quint32(Names.size());
+        NameLengths << quint16(Name.size());
+        Sizes << Size.width() << Size.height();
+        Names += Name;
+    }
+
+    SessionHeader Header;
+    std::memset(&Header, 0, sizeof(Header));
+    std::memcpy(Header.Magic, SESSION_MAGIC, sizeof(Header.Magic));
+    Header.Version        = SESSION_VERSION;
+    Header.ByteOrder      = SESSION_BYTE_ORDER;
+    Header.Method         = quint32(parameters.Method);
+    Header.Percentage     = parameters.Percentage;
+    Header.AbsoluteSize   = parameters.AbsoluteSize;
+    Header.DirectoryCount = quint32(DirectoryLengths.count());
+    Header.FileCount      = quint32(DirectoryIds.count());
+    Header.DirectoryPool  = quint64(Directories.size());
+    Header.NamePool       = quint64(Names.size());
+
+    QSaveFile File(filename);
+    if (!File.open(QIODevice::WriteOnly)) {
+        *error = File.errorString();
+        return false;
+    }
+
+    // Write a section, padded to 8 bytes
+    auto section = [&File](const void* data, qint64 size) {
+        static const char Padding[8] = {};
+        File.write(static_cast<const char*>(data), size);
+        File.write(Padding, qint64(aligned(quint64(size))) - size);
+    };
+    section(&Header, sizeof(Header));
+    section(DirectoryLengths.constData(), DirectoryLengths.count() * qint64(sizeof(quint32)));
+    section(DirectoryIds.constData(), DirectoryIds.count() * qint64(sizeof(quint32)));
+    section(NameOffsets.constData(), NameOffsets.count() * qint64(sizeof(quint32)));
+    section(NameLengths.constData(), NameLengths.count() * qint64(sizeof(quint16)));
+    section(Sizes.constData(), Sizes.count() * qint64(sizeof(qint32)));
+    section(Directories.constData(), Directories.size() * qint64(sizeof(QChar)));
+    section(Names.constData(), Names.size() * qint64(sizeof(QChar)));
+    if (!File.commit()) {
+        *error = File.errorString();
+        return false;
+    }
+    return true;
+}
+
+//
+//  load
+//
+// Add the files of a session to a store, and give the ids of the new files in the session order.
+// The file is memory-mapped, and checked as a whole before anything is added: a corrupt session adds nothing.
+// If validate is true, the files which don't exist anymore are skipped (one stat() per file).
+// Files already present in the store are ignored, like duplicate drops
+//
+
+bool SessionFile::load(const QString& filename, FileStore* store, QVector<quint32>* ids, ResizeParameters* parameters, bool validate, int* skipped, QString* error)
+{
+    *skipped = 0;
+    QFile File(filename);
+    if (!File.open(QIODevice::ReadOnly)) {
+        *error = File.errorString();
+        return false;
+    }
+
+    // Map the file. Some file systems can't be mapped, read them instead
+    quint64      Size = quint64(File.size());
+    QByteArray   Content;
+    const uchar* Data = File.map(0, qint64(Size));
+    if (Data == nullptr) {
+        Content = File.readAll();
+        Data    = reinterpret_cast<const uchar*>(Content.constData());
+    }
+
+    SessionHeader Header;
+    *error = QString("%1 is not a valid session file").arg(filename);
+    if (Size < sizeof(Header)) {
+        return false;
+    }
+    std::memcpy(&Header, Data, sizeof(Header));
+    if ((std::memcmp(Header.Magic, SESSION_MAGIC, sizeof(Header.Magic)) != 0) || (Header.Version != SESSION_VERSION) || (Header.ByteOrder != SESSION_BYTE_ORDER)
+        || (Header.DirectoryPool > Size) || (Header.NamePool > Size)) {
+        return false;
+    }
+
+    // Locate the sections. The file must end with the name pool
+    quint64 Count           = Header.FileCount;
+    quint64 LengthsOffset   = aligned(sizeof(Header));
+    quint64 IdsOffset       = LengthsOffset + aligned(Header.DirectoryCount * quint64(sizeof(quint32)));
+    quint64 OffsetsOffset   = IdsOffset + aligned(Count * sizeof(quint32));
+    quint64 NamesOffset     = OffsetsOffset + aligned(Count * sizeof(quint32));
+    quint64 SizesOffset     = NamesOffset + aligned(Count * sizeof(quint16));
+    quint64 DirectoryOffset = SizesOffset + aligned(2 * Count * sizeof(qint32));
+    quint64 PoolOffset      = DirectoryOffset + aligned(Header.DirectoryPool * sizeof(QChar));
+    if (PoolOffset + aligned(Header.NamePool * sizeof(QChar)) != Size) {
+        return false;
+    }
+
+    const quint32* DirectoryLengths = reinterpret_cast<const quint32*>(Data + LengthsOffset);
+    const quint32* DirectoryIds     = reinterpret_cast<const quint32*>(Data + IdsOffset);
+    const quint32* NameOffsets      = reinterpret_cast<const quint32*>(Data + OffsetsOffset);
+    const quint16* NameLengths      = reinterpret_cast<const quint16*>(Data + NamesOffset);
+    const qint32*  Sizes            = reinterpret_cast<const qint32*>(Data + SizesOffset);
+    const QChar*   Directories      = reinterpret_cast<const QChar*>(Data + DirectoryOffset);
+    const QChar*   Names            = reinterpret_cast<const QChar*>(Data + PoolOffset);
+
+    // Check every entry before adding anything
+    quint64 Position = 0;
+    for (quint32 i = 0; i < Header.DirectoryCount; i++) {
+        Position += DirectoryLengths[i];
+    }
+    if (Position != Header.DirectoryPool) {
+        return false;
+    }
+    for (quint64 i = 0; i < Count; i++) {
+        if ((DirectoryIds[i] >= Header.DirectoryCount) || (NameLengths[i] == 0) || (quint64(NameOffsets[i]) + NameLengths[i] > Header.NamePool)) {
+            return false;
+        }
+    }
+    error->clear();
+
+    // Intern the directories, then add the files
+    QVector<int> StoreDirectories;
+    QStringList  Paths;
+    Position = 0;
+    for (quint32 i = 0; i < Header.DirectoryCount; i++) {
+        Paths << QString(Directories + Position, int(DirectoryLengths[i]));
+        StoreDirectories << store->addDirectory(Paths.last());
+        Position += DirectoryLengths[i];
+    }
+
+    ids->reserve(ids->count() + int(Count));
+    store->reserve(store->count() + int(Count));
+    for (quint64 i = 0; i < Count; i++) {
+        const QChar* Name = Names + NameOffsets[i];
+        if (validate && !QFileInfo::exists(Paths.at(DirectoryIds[i]) + QString(Name, NameLengths[i]))) {
+            (*skipped)++;
+            continue;
+        }
+        int Id = store->append(StoreDirectories.at(DirectoryIds[i]), Name, NameLengths[i], QSize(Sizes[2 * i], Sizes[2 * i + 1]));
+        if (Id != -1) {
+            *ids << quint32(Id);
+        }
+    }
+
+    bool Absolute = Header.Method == ResizeParameters::MethodAbsoluteSize;
+    *parameters   = ResizeParameters(Absolute ? ResizeParameters::MethodAbsoluteSize : ResizeParameters::MethodPercentage, Header.Percentage, Header.AbsoluteSize);
+    return true;
+}
@@ -0,0 +1,94 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef SESSIONFILE_HPP
+#define SESSIONFILE_HPP
+
+#include "FileStore.hpp"
+#include "ResizeParameters.hpp"
+#include <QString>
+#include <QVector>
+
+//
+//  SessionFile
+//
+// This class saves a file list (paths, original sizes, resizing method) in a compact binary file, and loads it back
+// without scanning nor probing anything. The layout follows the FileStore columns, so loading is a single pass
+// over the memory-mapped file: directories are interned once, names are copied from the mapped pool.
+//
+// Layout, in the byte order of the machine which wrote it (checked when loading). Sections are aligned on 8 bytes:
+//   header            SessionHeader
+//   directory lengths quint32[DirectoryCount], in UTF-16 units
+//   directory ids     quint32[FileCount]
+//   name offsets      quint32[FileCount], in UTF-16 units, relative to the name pool
+//   name lengths      quint16[FileCount]
+//   sizes             qint32[2 * FileCount], width then height
+//   directories       UTF-16, concatenated
+//   name pool         UTF-16, concatenated
+//
+
+class SessionFile
+{
+  public:
+    static bool save(const QString& filename, const FileStore& store, const QVector<quint32>& ids, const ResizeParameters& parameters, QString* error);            // Save files of a store, in the given order
+    static bool load(const QString& filename, FileStore* store, QVector<quint32>* ids, ResizeParameters* parameters, bool validate, int* skipped, QString* error); // Add the files of a session to a store. Give the ids of the new files
+};
+
+//
+//  SessionHeader
+//
+// Fixed-size header of a session file
+//
+
+struct SessionHeader
+{
+    char    Magic[8];       // SESSION_MAGIC
+    quint32 Version;        // SESSION_VERSION
+    quint32 ByteOrder;      // SESSION_BYTE_ORDER, as written by the machine
+    quint32 Method;         // ResizeParameters::ResizingMethod
+    qint32  Percentage;     // ResizeParameters::Percentage
+    qint32  AbsoluteSize;   // ResizeParameters::AbsoluteSize
+    quint32 DirectoryCount; // Number of directories
+    quint32 FileCount;      // Number of files
+    quint32 Reserved;       // Keep the header aligned, 0
+    quint64 DirectoryPool;  // Size of the concatenated directories, in UTF-16 units
+    quint64 NamePool;       // Size of the name pool, in UTF-16 units
+};
+
+//
+//  Signature and version of the session files
+//
+
+#define SESSION_MAGIC "PICRESSF"
+#define SESSION_VERSION 1
+
+//
+//  Marker used to detect a file written with another byte order
+//
+
+#define SESSION_BYTE_ORDER 0x01020304
+
+//
+//  Extension of the session files
+//
+
+#define SESSION_EXTENSION "picres"
+
+#endif // SESSIONFILE_HPP
@@ -0,0 +1,386 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "StageMetrics.hpp"
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QTextStream>
+#include <cstring>
+
+//
+//  StageStatistics
+//
+// Constructor
+//
+
+StageStatistics::StageStatistics()
+{
+    clear();
+}
+
+//
+//  record
+//
+// Add the measure of a stage
+//
+
+void StageStatistics::record(Stage stage, qint64 ns, qint64 bytes, qint64 pixels)
+{
+    Counters& Current = this->Stages[stage];
+    Current.Count++;
+    Current.Nanoseconds += ns;
+    Current.Max          = qMax(Current.Max, ns);
+    Current.Bytes       += bytes;
+    Current.Pixels      += pixels;
+    Current.Histogram[bucket(ns)]++;
+}
+
+//
+//  merge
+//
+// Add the measures of another object, to sum several processes
+//
+
+void StageStatistics::merge(const StageStatistics& other)
+{
+    for (int i = 0; i < StageCount; i++) {
+        Counters&       Current = this->Stages[i];
+        const Counters& Other   = other.Stages[i];
+        Current.Count       += Other.Count;
+        Current.Nanoseconds += Other.Nanoseconds;
+        Current.Max          = qMax(Current.Max, Other.Max);
+        Current.Bytes       += Other.Bytes;
+        Current.Pixels      += Other.Pixels;
+        for (int j = 0; j < STAGE_METRICS_BUCKETS; j++) {
+            Current.Histogram[j] += Other.Histogram[j];
+        }
+    }
+}
+
+//
+//  clear
+//
+// Remove all the measures
+//
+
+void StageStatistics::clear()
+{
+    std::memset(this->Stages, 0, sizeof(this->Stages));
+}
+
+//
+//  isEmpty
+//
+// Return true if no stage has been measured
+//
+
+bool StageStatistics::isEmpty() const
+{
+    for (int i = 0; i < StageCount; i++) {
+        if (this->Stages[i].Count != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//
+//  count
+//
+// Return the number of measures of a stage
+//
+
+qint64 StageStatistics::count(Stage stage) const
+{
+    return this->Stages[stage].Count;
+}
+
+//
+//  nanoseconds
+//
+// Return the total time spent in a stage, in ns
+//
+
+qint64 StageStatistics::nanoseconds(Stage stage) const
+{
+    return this->Stages[stage].Nanoseconds;
+}
+
+//
+//  bytes
+//
+// Return the total bytes read or written by a stage
+//
+
+qint64 StageStatistics::bytes(Stage stage) const
+{
+    return this->Stages[stage].Bytes;
+}
+
+//
+//  pixels
+//
+// Return the total pixels handled by a stage
+//
+
+qint64 StageStatistics::pixels(Stage stage) const
+{
+    return this->Stages[stage].Pixels;
+}
+
+//
+//  percentile
+//
+// Upper bound of the duration below which a percentage of the measures are (nearest rank), in ns.
+// The bound of a bucket is twice its lower bound, so it never exceeds the longest measure
+//
+
+qint64 StageStatistics::percentile(Stage stage, int percent) const
+{
+    const Counters& Current = this->Stages[stage];
+    qint64          Rank    = (Current.Count * percent + 99) / 100;
+    qint64          Seen    = 0;
+    for (int i = 0; i < STAGE_METRICS_BUCKETS; i++) {
+        Seen += Current.Histogram[i];
+        if ((Seen >= Rank) && (Seen != 0)) {
+            return qMin(upperBound(i), Current.Max);
+        }
+    }
+    return Current.Max;
+}
+
+//
+//  summary
+//
+// Human-readable report, one line per measured stage. Throughputs are given per worker: they are computed from the time
+// spent in the stage, summed over all the threads
+//
+
+QString StageStatistics::summary() const
+{
+    QStringList Lines;
+    for (int i = 0; i < StageCount; i++) {
+        Stage           Measured = Stage(i);
+        const Counters& Current  = this->Stages[i];
+        if (Current.Count == 0) {
+            continue;
+        }
+        double Seconds = qMax(Current.Nanoseconds, qint64(1)) / 1e9;
+        Lines << QString("%1: %2 files, %3 s, %4 MB/s, %5 Mpx/s, p50 %6 ms, p90 %7 ms, p99 %8 ms, max %9 ms")
+                     .arg(stageName(Measured), -8)
+                     .arg(Current.Count)
+                     .arg(Seconds, 0, 'f', 3)
+                     .arg(Current.Bytes / 1e6 / Seconds, 0, 'f', 1)
+                     .arg(Current.Pixels / 1e6 / Seconds, 0, 'f', 1)
+                     .arg(percentile(Measured, 50) / 1e6, 0, 'f', 1)
+                     .arg(percentile(Measured, 90) / 1e6, 0, 'f', 1)
+                     .arg(percentile(Measured, 99) / 1e6, 0, 'f', 1)
+                     .arg(Current.Max / 1e6, 0, 'f', 1);
+    }
+    return Lines.join('\n');
+}
+
+//
+//  toJson
+//
+// Report with a line per stage, including the non-empty buckets of the histogram. Stages are always present, even if empty,
+// so the report has the same shape for every process
+//
+
+QByteArray StageStatistics::toJson() const
+{
+    QJsonArray Stages;
+    for (int i = 0; i < StageCount; i++) {
+        Stage           Measured = Stage(i);
+        const Counters& Current  = this->Stages[i];
+        double          Seconds  = Current.Nanoseconds / 1e9;
+
+        QJsonArray Histogram;
+        for (int j = 0; j < STAGE_METRICS_BUCKETS; j++) {
+            if (Current.Histogram[j] != 0) {
+                Histogram << QJsonObject {{"le_us", upperBound(j) / 1000}, {"count", qint64(Current.Histogram[j])}};
+            }
+        }
+
+        QJsonObject Object;
+        Object["stage"]                 = stageName(Measured);
+        Object["count"]                 = Current.Count;
+        Object["total_ms"]              = Current.Nanoseconds / 1e6;
+        Object["bytes"]                 = Current.Bytes;
+        Object["pixels"]                = Current.Pixels;
+        Object["mb_per_second"]         = Seconds > 0 ? Current.Bytes / 1e6 / Seconds : 0.0;
+        Object["megapixels_per_second"] = Seconds > 0 ? Current.Pixels / 1e6 / Seconds : 0.0;
+        Object["mean_ms"]               = Current.Count > 0 ? Current.Nanoseconds / 1e6 / Current.Count : 0.0;
+        Object["p50_ms"]                = percentile(Measured, 50) / 1e6;
+        Object["p90_ms"]                = percentile(Measured, 90) / 1e6;
+        Object["p99_ms"]                = percentile(Measured, 99) / 1e6;
+        Object["max_ms"]                = Current.Max / 1e6;
+        Object["histogram"]             = Histogram;
+        Stages << Object;
+    }
+
+    return QJsonDocument(QJsonObject {{"stages", Stages}}).toJson();
+}
+
+//
+//  toCsv
+//
+// Report with a line per stage, without the histograms, for spreadsheets
+//
+
+QByteArray StageStatistics::toCsv() const
+{
+    QByteArray  Csv;
+    QTextStream Stream(&Csv);
+    Stream << "stage,count,total_ms,bytes,pixels,mb_per_second,megapixels_per_second,mean_ms,p50_ms,p90_ms,p99_ms,max_ms\n";
+    for (int i = 0; i < StageCount; i++) {
+        Stage           Measured = Stage(i);
+        const Counters& Current  = this->Stages[i];
+        double          Seconds  = Current.Nanoseconds / 1e9;
+        Stream << stageName(Measured) << "," << Current.Count << "," << QString::number(Current.Nanoseconds / 1e6, 'f', 3) << "," << Current.Bytes << ","
+               << Current.Pixels << "," << QString::number(Seconds > 0 ? Current.Bytes / 1e6 / Seconds : 0.0, 'f', 3) << ","
+               << QString::number(Seconds > 0 ? Current.Pixels / 1e6 / Seconds : 0.0, 'f', 3) << ","
+               << QString::number(Current.Count > 0 ? Current.Nanoseconds / 1e6 / Current.Count : 0.0, 'f', 3) << ","
+               << QString::number(percentile(Measured, 50) / 1e6, 'f', 3) << "," << QString::number(percentile(Measured, 90) / 1e6, 'f', 3) << ","
+               << QString::number(percentile(Measured, 99) / 1e6, 'f', 3) << "," << QString::number(Current.Max / 1e6, 'f', 3) << "\n";
+    }
+    Stream.flush();
+    return Csv;
+}
+
+//
+//  write
+//
+// Write the report to a file: CSV if its name ends with .csv, JSON otherwise
+//
+
+bool StageStatistics::write(const QString& filename) const
+{
+    QFile      File(filename);
+    QByteArray Report = (QFileInfo(filename).suffix().toLower() == "csv") ? toCsv() : toJson();
+    return File.open(QIODevice::WriteOnly | QIODevice::Truncate) && (File.write(Report) == Report.size());
+}
+
+//
+//  stageName
+//
+// Name of a stage, used in reports
+//
+
+QString StageStatistics::stageName(Stage stage)
+{
+    switch (stage) {
+        case StageProbe:
+            return "probe";
+        case StageRead:
+            return "read";
+        case StageDecode:
+            return "decode";
+        case StageResample:
+            return "resample";
+        case StageEncode:
+            return "encode";
+        case StageWrite:
+            return "write";
+        default:
+            return "unknown";
+    }
+}
+
+//
+//  bucket
+//
+// Bucket of a duration: 0 below 1 us, then i for [2^(i-1), 2^i[ us. The last bucket holds the longer durations
+//
+
+int StageStatistics::bucket(qint64 ns)
+{
+    qint64 Microseconds = ns / 1000;
+    int    Index        = 0;
+    while ((Microseconds > 0) && (Index < STAGE_METRICS_BUCKETS - 1)) {
+        Microseconds >>= 1;
+        Index++;
+    }
+    return Index;
+}
+
+//
+//  upperBound
+//
+// Longest duration of a bucket, in ns
+//
+
+qint64 StageStatistics::upperBound(int index)
+{
+    return (qint64(1) << index) * 1000;
+}
+
+//
+//  StageMetrics
+//
+// Constructor
+//
+
+StageMetrics::StageMetrics()
+{
+}
+
+//
+//  instance
+//
+// Return the unique instance, created on first use
+//
+
+StageMetrics* StageMetrics::instance()
+{
+    static StageMetrics Instance;
+    return &Instance;
+}
+
+//
+//  record
+//
+// Add the measure of a stage. Called by the drop thread and the resize workers
+//
+
+void StageMetrics::record(StageStatistics::Stage stage, qint64 ns, qint64 bytes, qint64 pixels)
+{
+    QMutexLocker Locker(&this->Mutex);
+    this->Statistics.record(stage, ns, bytes, pixels);
+}
+
+//
+//  take
+//
+// Return the measures collected since the last call, and start a new collection
+//
+
+StageStatistics StageMetrics::take()
+{
+    QMutexLocker    Locker(&this->Mutex);
+    StageStatistics Statistics = this->Statistics;
+    this->Statistics.clear();
+    return Statistics;
+}
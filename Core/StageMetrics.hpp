@@ -0,0 +1,113 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef STAGEMETRICS_HPP
+#define STAGEMETRICS_HPP
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+
+//
+//  Number of buckets of the duration histograms. The last one holds everything longer than 2^30 us (about 18 minutes)
+//
+
+#define STAGE_METRICS_BUCKETS 32
+
+//
+//  StageStatistics
+//
+// This class aggregates the measures of the processing stages of the files: for each stage, the number of files,
+// the time spent (monotonic clock), the bytes and pixels handled, and a histogram of the durations.
+// Buckets are powers of two in microseconds, so the histogram has a fixed size whatever the number of files,
+// and percentiles are known within a factor of two
+//
+
+class StageStatistics
+{
+  public:
+    StageStatistics();
+
+    // Measured stages
+    enum Stage : quint8 {
+        StageProbe,    // Reading of the header of a dropped file
+        StageRead,     // Reading of the file to resize
+        StageDecode,   // Decoding of the picture
+        StageResample, // Resampling to the new size
+        StageEncode,   // Encoding of the resized picture
+        StageWrite,    // Writing of the resized picture
+        StageCount,    // Number of stages
+    };
+
+    void       record(Stage stage, qint64 ns, qint64 bytes, qint64 pixels); // Add the measure of a stage
+    void       merge(const StageStatistics& other);                         // Add the measures of another object
+    void       clear();                                                     // Remove all the measures
+    bool       isEmpty() const;                                             // Return true if nothing has been measured
+    qint64     count(Stage stage) const;                                    // Number of measures of a stage
+    qint64     nanoseconds(Stage stage) const;                              // Total time spent in a stage
+    qint64     bytes(Stage stage) const;                                    // Total bytes read or written by a stage
+    qint64     pixels(Stage stage) const;                                   // Total pixels handled by a stage
+    qint64     percentile(Stage stage, int percent) const;                  // Upper bound of the duration of a percentile, in ns
+    QString    summary() const;                                             // Human-readable report, one line per stage
+    QByteArray toJson() const;                                              // Report with the histograms
+    QByteArray toCsv() const;                                               // Report without the histograms, one line per stage
+    bool       write(const QString& filename) const;                        // Write the report as CSV if the file ends with .csv, as JSON otherwise
+
+    static QString stageName(Stage stage); // Name used in reports
+
+  private:
+    struct Counters
+    {
+        qint64  Count;                            // Number of measures
+        qint64  Nanoseconds;                      // Total time
+        qint64  Max;                              // Longest measure
+        qint64  Bytes;                            // Total bytes
+        qint64  Pixels;                           // Total pixels
+        quint32 Histogram[STAGE_METRICS_BUCKETS]; // Number of measures per bucket
+    };
+
+    static int    bucket(qint64 ns);     // Bucket of a duration
+    static qint64 upperBound(int index); // Longest duration of a bucket, in ns
+
+    Counters Stages[StageCount]; // Measures of each stage
+};
+
+//
+//  StageMetrics
+//
+// This class collects the measures of the whole program: probes are recorded by the drop thread, other stages by the
+// resize workers, or received from the worker processes. The resize thread takes them at the end of each process
+//
+
+class StageMetrics
+{
+  public:
+    static StageMetrics* instance();                                                                   // Return the unique instance, created on first use
+    void                 record(StageStatistics::Stage stage, qint64 ns, qint64 bytes, qint64 pixels); // Add the measure of a stage. Thread-safe
+    StageStatistics      take();                                                                       // Return the measures collected so far, and clear them
+
+  private:
+    StageMetrics();
+
+    StageStatistics Statistics; // Measures collected since the last take()
+    QMutex          Mutex;      // Control access to the measures
+};
+
+#endif // STAGEMETRICS_HPP
@@ -0,0 +1,244 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "ThumbnailThread.hpp"
+#include "ExifThumbnail.hpp"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QStandardPaths>
+
+//
+//  thumbnailthread
+//
+// Static variable containing a pointer to the unique ThumbnailThread instance
+//
+
+ThumbnailThread* ThumbnailThread::thumbnailthread = nullptr;
+
+//
+//  ThumbnailThread
+//
+// Constructor. The disk cache is disabled by default
+//
+
+ThumbnailThread::ThumbnailThread()
+    : DiskCache(false)
+{
+}
+
+//
+//  instance
+//
+// Return a pointer to the ThumbnailThread instance. Instantiate it if it doesn't exist yet
+//
+
+ThumbnailThread* ThumbnailThread::instance()
+{
+    if (thumbnailthread == nullptr) {
+        thumbnailthread = new ThumbnailThread;
+    }
+    return thumbnailthread;
+}
+
+//
+//  release
+//
+// Stop the worker and delete the thread if it exists
+//
+
+void ThumbnailThread::release()
+{
+    if (thumbnailthread != nullptr) {
+        thumbnailthread->requestInterruption();
+        thumbnailthread->MutexQueue.lock();
+        thumbnailthread->QueueNotEmpty.wakeAll();
+        thumbnailthread->MutexQueue.unlock();
+        thumbnailthread->wait();
+        delete thumbnailthread;
+        thumbnailthread = nullptr;
+    }
+}
+
+//
+//  request
+//
+// Queue a thumbnail request. If the queue is full, the oldest request is discarded: its row is probably not visible anymore
+//
+
+void ThumbnailThread::request(int id, int generation, QString filename)
+{
+    QList<Request> Discarded;
+
+    this->MutexQueue.lock();
+    this->Queue << Request {id, generation, filename};
+    while (this->Queue.count() > THUMBNAIL_QUEUE_SIZE) {
+        Discarded << this->Queue.takeFirst();
+    }
+    this->QueueNotEmpty.wakeOne();
+    this->MutexQueue.unlock();
+
+    for (int i = 0; i < Discarded.count(); i++) {
+        emit thumbnailDiscarded(Discarded.at(i).Id, Discarded.at(i).Generation);
+    }
+
+    // Start the thread (harmless if already started)
+    start(QThread::LowPriority);
+}
+
+//
+//  cancel
+//
+// Discard all pending requests. Used when the table is cleared
+//
+
+void ThumbnailThread::cancel()
+{
+    this->MutexQueue.lock();
+    this->Queue.clear();
+    this->MutexQueue.unlock();
+}
+
+//
+//  setDiskCacheEnabled
+//
+// Enable or disable the persistence of thumbnails in the user cache directory
+//
+
+void ThumbnailThread::setDiskCacheEnabled(bool enabled)
+{
+    QString Path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails";
+    if (enabled && !QDir().mkpath(Path)) {
+        enabled = false;
+    }
+
+    QMutexLocker Locker(&this->MutexQueue);
+    this->DiskCache     = enabled;
+    this->DiskCachePath = Path;
+}
+
+//
+//  run
+//
+// Serve the requests, most recent first, and sleep when there is nothing to do.
+// The interruption is checked again under the lock before sleeping: release() wakes the thread under the same lock,
+// so its wake-up can't be lost between the check and the wait.
+// This method runs in a separate thread
+//
+
+void ThumbnailThread::run()
+{
+    while (!isInterruptionRequested()) {
+        this->MutexQueue.lock();
+        while (this->Queue.isEmpty() && !isInterruptionRequested()) {
+            this->QueueNotEmpty.wait(&this->MutexQueue);
+        }
+        if (this->Queue.isEmpty()) {
+            this->MutexQueue.unlock();
+            break;
+        }
+        Request Current = this->Queue.takeLast();
+        this->MutexQueue.unlock();
+
+        emit thumbnailReady(Current.Id, Current.Generation, load(Current.Filename));
+    }
+}
+
+//
+//  load
+//
+// Build the thumbnail of a file: from the disk cache, from the EXIF preview of a JPEG file,
+// or by decoding the picture at a reduced scale. Return a null image if the file couldn't be read
+//
+
+QImage ThumbnailThread::load(const QString& filename) const
+{
+    // Try the disk cache first
+    QString CacheFilename = diskCacheFilename(filename);
+    if (!CacheFilename.isEmpty()) {
+        QImage Cached(CacheFilename);
+        if (!Cached.isNull()) {
+            return Cached;
+        }
+    }
+
+    QImage       Image;
+    QImageReader Reader(filename);
+
+    // JPEG: use the embedded preview if there is one
+    if (Reader.format() == "jpeg") {
+        ExifThumbnail Exif(filename);
+        if (Exif.isValid()) {
+            Image = ExifThumbnail::applyOrientation(Exif.image(), Exif.orientation());
+        }
+    }
+
+    // Else decode the picture at a reduced scale. JPEG decoders scale while decoding, which is much faster
+    if (Image.isNull()) {
+        QSize Size = Reader.size();
+        if (Size.isValid()) {
+            Reader.setScaledSize(Size.scaled(THUMBNAIL_SIZE, THUMBNAIL_SIZE, Qt::KeepAspectRatio).expandedTo(QSize(1, 1)));
+        }
+        Reader.setAutoTransform(true);
+        if (!Reader.read(&Image)) {
+            return QImage();
+        }
+    }
+
+    if ((Image.width() > THUMBNAIL_SIZE) || (Image.height() > THUMBNAIL_SIZE)) {
+        Image = Image.scaled(THUMBNAIL_SIZE, THUMBNAIL_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+
+    if (!CacheFilename.isEmpty()) {
+        Image.save(CacheFilename, "PNG");
+    }
+
+    return Image;
+}
+
+//
+//  diskCacheFilename
+//
+// Return the name of the cached thumbnail of a file. The key includes the size and the modification date,
+// so a modified picture gets a new thumbnail. Return an empty string if the disk cache is disabled
+//
+
+QString ThumbnailThread::diskCacheFilename(const QString& filename) const
+{
+    // The settings may be changed from the UI thread
+    QMutexLocker Locker(&this->MutexQueue);
+    if (!this->DiskCache) {
+        return QString();
+    }
+    QString Path = this->DiskCachePath;
+    Locker.unlock();
+
+    QFileInfo Info(filename);
+    if (!Info.exists()) {
+        return QString();
+    }
+
+    QString    Key  = QString("%1|%2|%3").arg(Info.absoluteFilePath()).arg(Info.size()).arg(Info.lastModified().toMSecsSinceEpoch());
+    QByteArray Hash = QCryptographicHash::hash(Key.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return Path + "/" + QString::fromLatin1(Hash) + ".png";
+}
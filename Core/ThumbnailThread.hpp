@@ -0,0 +1,92 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef THUMBNAILTHREAD_HPP
+#define THUMBNAILTHREAD_HPP
+
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+//
+//  ThumbnailThread
+//
+// This class is a worker thread that loads the thumbnails displayed in the main table.
+// Unlike the other workers, it waits for requests until it's released.
+// Requests are served last in, first out: the most recent ones are the rows currently visible.
+// Old requests are discarded when the queue is full, which happens when the table is scrolled quickly.
+// Embedded EXIF previews are used when available, else the picture is decoded at a reduced scale.
+// Thumbnails may be persisted in the user cache directory
+//
+
+class ThumbnailThread: public QThread
+{
+    Q_OBJECT
+
+  public:
+    static ThumbnailThread* instance();                                        // Return a ptr to the object instance; create it if needed
+    static void             release();                                         // Stop and delete the thread if it was created
+    void                    request(int id, int generation, QString filename); // Ask for the thumbnail of a file
+    void                    cancel();                                          // Discard all pending requests
+    void                    setDiskCacheEnabled(bool enabled);                 // Enable or disable the on-disk thumbnail cache
+
+  private:
+    ThumbnailThread();
+
+    void    run() override;                                   // Worker
+    QImage  load(const QString& filename) const;              // Build the thumbnail of a file
+    QString diskCacheFilename(const QString& filename) const; // Name of the cached thumbnail of a file, empty if it can't be cached
+
+    // A pending request
+    struct Request
+    {
+        int     Id;
+        int     Generation;
+        QString Filename;
+    };
+
+    static ThumbnailThread* thumbnailthread; // Singleton pointer
+    QList<Request>          Queue;           // Pending requests, the last one is served first
+    mutable QMutex          MutexQueue;      // Control access to the queue and to the disk cache settings
+    QWaitCondition          QueueNotEmpty;   // Wake up the worker when a request arrives
+    bool                    DiskCache;       // True if thumbnails are persisted on disk
+    QString                 DiskCachePath;   // Directory of the on-disk cache
+
+  signals:
+    void thumbnailReady(int id, int generation, QImage thumbnail); // A thumbnail has been loaded. Null if the file couldn't be read
+    void thumbnailDiscarded(int id, int generation);               // A request has been dropped before being served
+};
+
+//
+//  Size of the thumbnails displayed in the table, in pixels
+//
+
+#define THUMBNAIL_SIZE 64
+
+//
+//  Maximum number of pending thumbnail requests
+//
+
+#define THUMBNAIL_QUEUE_SIZE 256
+
+#endif // THUMBNAILTHREAD_HPP
@@ -0,0 +1,261 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "TraceRecorder.hpp"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+#include <QVector>
+
+namespace {
+
+    // Event of the timeline
+    struct TraceEvent
+    {
+        const char* Name;     // Name of the event, a literal
+        qint64      Start;    // Start of the event, in ns since the recording started
+        qint64      Duration; // Duration of the event, in ns
+        qint32      Id;       // Id of the job, -1 if none
+        quint32     Thread;   // Index of the thread which recorded the event
+    };
+
+    // Ring buffer of a thread. Only the owner thread writes. Head is the number of events ever written
+    struct TraceBuffer
+    {
+        QVector<TraceEvent>  Events; // TRACE_BUFFER_EVENTS slots
+        std::atomic<quint64> Head;   // Number of events written
+        quint32              Thread; // Index of the thread currently owning the buffer
+    };
+
+    // Buffers, thread names and clock shared by all the threads. The mutex is only taken when a thread records
+    // its first event, when it terminates, and when the trace is written
+    struct TraceRegistry
+    {
+        ~TraceRegistry() { qDeleteAll(this->Buffers); }
+
+        QMutex              Mutex;       // Control access to the lists
+        QElapsedTimer       Clock;       // Time origin of the events
+        QString             Filename;    // Trace file
+        QList<TraceBuffer*> Buffers;     // All the buffers
+        QList<TraceBuffer*> FreeBuffers; // Buffers of the terminated threads
+        QStringList         ThreadNames; // Name of each thread, by index
+    };
+
+    TraceRegistry& registry()
+    {
+        static TraceRegistry Registry;
+        return Registry;
+    }
+
+    // Buffer of the calling thread. It's given back to the registry when the thread terminates
+    struct ThreadBuffer
+    {
+        ~ThreadBuffer()
+        {
+            if (this->Buffer != nullptr) {
+                TraceRegistry& Registry = registry();
+                QMutexLocker   Locker(&Registry.Mutex);
+                Registry.FreeBuffers << this->Buffer;
+            }
+        }
+
+        TraceBuffer* Buffer = nullptr;
+    };
+
+    thread_local ThreadBuffer CurrentBuffer;
+
+    // Give a buffer to the calling thread, and name the thread after its class (DropThread, ResizeThread, pool threads)
+    TraceBuffer* acquireBuffer()
+    {
+        TraceRegistry& Registry = registry();
+        QMutexLocker   Locker(&Registry.Mutex);
+
+        TraceBuffer* Buffer = nullptr;
+        if (!Registry.FreeBuffers.isEmpty()) {
+            Buffer = Registry.FreeBuffers.takeLast();
+        }
+        else {
+            Buffer = new TraceBuffer;
+            Buffer->Events.resize(TRACE_BUFFER_EVENTS);
+            Buffer->Head.store(0);
+            Registry.Buffers << Buffer;
+        }
+
+        QThread* Thread = QThread::currentThread();
+        QString  Name   = Thread->objectName().isEmpty() ? QString(Thread->metaObject()->className()) : Thread->objectName();
+        Buffer->Thread  = quint32(Registry.ThreadNames.count());
+        Registry.ThreadNames << QString("%1 %2").arg(Name).arg(Buffer->Thread);
+        return Buffer;
+    }
+
+} // namespace
+
+std::atomic<bool> TraceRecorder::Enabled(false);
+
+//
+//  start
+//
+// Start recording. Events are timed from now
+//
+
+void TraceRecorder::start(const QString& filename)
+{
+    if (filename.isEmpty()) {
+        return;
+    }
+
+    TraceRegistry& Registry = registry();
+    QMutexLocker   Locker(&Registry.Mutex);
+    Registry.Filename = filename;
+    Registry.Clock.start();
+    Enabled.store(true);
+}
+
+//
+//  stop
+//
+// Stop recording and write the trace: a complete event ("X") per recorded event, and the names of the threads.
+// Threads should be idle: an event written while the buffers are read may be lost
+//
+
+bool TraceRecorder::stop()
+{
+    if (!Enabled.exchange(false)) {
+        return true;
+    }
+
+    TraceRegistry& Registry = registry();
+    QMutexLocker   Locker(&Registry.Mutex);
+    QFile          File(Registry.Filename);
+    if (!File.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return false;
+    }
+
+    QTextStream Stream(&File);
+    QString     Process = QCoreApplication::applicationName();
+    Stream << "{\"traceEvents\":[\n";
+    Stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"" << Process.replace('"', '\'') << "\"}}";
+    for (int i = 0; i < Registry.ThreadNames.count(); i++) {
+        QString Name = Registry.ThreadNames.at(i);
+        Stream << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":\"" << Name.replace('"', '\'') << "\"}}";
+    }
+
+    quint64 Dropped = 0;
+    for (TraceBuffer* Buffer : Registry.Buffers) {
+        quint64 Head  = Buffer->Head.load(std::memory_order_acquire);
+        quint64 First = Head > TRACE_BUFFER_EVENTS ? Head - TRACE_BUFFER_EVENTS : 0;
+        Dropped      += First;
+        for (quint64 i = First; i < Head; i++) {
+            const TraceEvent& Event = Buffer->Events.at(int(i % TRACE_BUFFER_EVENTS));
+            Stream << ",\n{\"name\":\"" << Event.Name << "\",\"cat\":\"picres\",\"ph\":\"X\",\"pid\":1,\"tid\":" << Event.Thread
+                   << ",\"ts\":" << QString::number(Event.Start / 1e3, 'f', 3) << ",\"dur\":" << QString::number(Event.Duration / 1e3, 'f', 3);
+            if (Event.Id >= 0) {
+                Stream << ",\"args\":{\"id\":" << Event.Id << "}";
+            }
+            Stream << "}";
+        }
+    }
+
+    Stream << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" << Dropped << "}}\n";
+    Stream.flush();
+    return Stream.status() == QTextStream::Ok;
+}
+
+//
+//  now
+//
+// Time elapsed since the recording started, in ns
+//
+
+qint64 TraceRecorder::now()
+{
+    return registry().Clock.nsecsElapsed();
+}
+
+//
+//  record
+//
+// Add an event to the buffer of the calling thread. Only this thread writes to its buffer, so no lock is needed:
+// the event is written first, then published by incrementing the head
+//
+
+void TraceRecorder::record(const char* name, int id, qint64 start, qint64 end)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    if (CurrentBuffer.Buffer == nullptr) {
+        CurrentBuffer.Buffer = acquireBuffer();
+    }
+
+    TraceBuffer* Buffer = CurrentBuffer.Buffer;
+    quint64      Head   = Buffer->Head.load(std::memory_order_relaxed);
+    TraceEvent&  Event  = Buffer->Events[int(Head % TRACE_BUFFER_EVENTS)];
+    Event.Name          = name;
+    Event.Start         = start;
+    Event.Duration      = end - start;
+    Event.Id            = id;
+    Event.Thread        = Buffer->Thread;
+    Buffer->Head.store(Head + 1, std::memory_order_release);
+}
+
+//
+//  TraceScope
+//
+// Constructor. Start the event if tracing is on
+//
+
+TraceScope::TraceScope(const char* name, int id)
+    : Name(name)
+    , Id(id)
+    , Start(TraceRecorder::isEnabled() ? TraceRecorder::now() : -1)
+{
+}
+
+//
+//  ~TraceScope
+//
+// Destructor. End the event if it's not finished yet
+//
+
+TraceScope::~TraceScope()
+{
+    finish();
+}
+
+//
+//  finish
+//
+// End the event. Further calls do nothing
+//
+
+void TraceScope::finish()
+{
+    if (this->Start >= 0) {
+        TraceRecorder::record(this->Name, this->Id, this->Start, TraceRecorder::now());
+        this->Start = -1;
+    }
+}
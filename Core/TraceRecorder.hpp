@@ -0,0 +1,77 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef TRACERECORDER_HPP
+#define TRACERECORDER_HPP
+
+#include <QString>
+#include <atomic>
+
+//
+//  TraceRecorder
+//
+// This class records a timeline of the worker threads, written as a Chrome trace (chrome://tracing, ui.perfetto.dev)
+// when recording stops. Each thread writes its events into its own ring buffer, without lock: recording an event costs
+// two clock reads and a few stores. When a buffer is full, its oldest events are overwritten.
+// Buffers of terminated threads are reused by the next threads, so thread pools recreated by each process don't grow the memory.
+// Tracing is off by default: a disabled scope costs a single atomic load
+//
+
+class TraceRecorder
+{
+  public:
+    static void   start(const QString& filename);                             // Start recording. An empty filename leaves tracing off
+    static bool   stop();                                                     // Stop recording and write the trace. Return false if it couldn't be written
+    static qint64 now();                                                      // Time elapsed since the recording started, in ns
+    static void   record(const char* name, int id, qint64 start, qint64 end); // Add an event to the buffer of the calling thread. Name must be a literal
+
+    // Inline, so a disabled scope costs nothing more than this load
+    static bool isEnabled() { return Enabled.load(std::memory_order_acquire); }
+
+  private:
+    static std::atomic<bool> Enabled; // True while recording
+};
+
+//
+//  TraceScope
+//
+// Record an event lasting from the construction of the scope to its destruction, or to the call to finish()
+//
+
+class TraceScope
+{
+  public:
+    TraceScope(const char* name, int id);
+    ~TraceScope();
+    void finish(); // End the event before the end of the scope
+
+  private:
+    const char* Name;  // Name of the event, a literal
+    int         Id;    // Id of the job, -1 if the event is not related to a job
+    qint64      Start; // Start of the event, -1 if tracing is off or the event is finished
+};
+
+//
+//  Number of events kept per thread. An event takes 32 bytes
+//
+
+#define TRACE_BUFFER_EVENTS 32768
+
+#endif // TRACERECORDER_HPP
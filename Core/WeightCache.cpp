@@ -0,0 +1,131 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "WeightCache.hpp"
+#include <QMutexLocker>
+
+//
+//  WeightCache
+//
+// Constructor
+//
+
+WeightCache::WeightCache()
+    : Cache(WEIGHT_CACHE_SIZE)
+    , Hits(0)
+    , Misses(0)
+{
+}
+
+//
+//  instance
+//
+// Return the unique instance. Unlike the thread singletons, it's a function-local static:
+// it's first used by the workers, and its construction must be thread-safe
+//
+
+WeightCache* WeightCache::instance()
+{
+    static WeightCache Instance;
+    return &Instance;
+}
+
+//
+//  weights
+//
+// Return the coefficients of one axis. On a miss, the table is computed outside of the lock so workers
+// don't wait for each other; if two workers compute the same table, the first one inserted wins
+//
+
+WeightCache::Weights WeightCache::weights(int source, int target, Resampler::Filter filter)
+{
+    quint64 Key = key(source, target, filter);
+
+    this->Mutex.lock();
+    Weights* Cached = this->Cache.object(Key);
+    if (Cached != nullptr) {
+        Weights Result = *Cached;
+        this->Hits++;
+        this->Mutex.unlock();
+        return Result;
+    }
+    this->Mutex.unlock();
+
+    Weights Computed(new ResampleWeights(source, target, filter));
+    int     Cost = qMax(1, int((Computed->Weights.size() * sizeof(float) + Computed->Start.size() * 2 * sizeof(int)) / 1024));
+
+    QMutexLocker Locker(&this->Mutex);
+    Cached = this->Cache.object(Key);
+    if (Cached != nullptr) {
+        return *Cached;
+    }
+    this->Misses++;
+    this->Cache.insert(Key, new Weights(Computed), Cost);
+    return Computed;
+}
+
+//
+//  clear
+//
+// Discard all the tables. Tables still used by a worker stay alive until it has finished
+//
+
+void WeightCache::clear()
+{
+    QMutexLocker Locker(&this->Mutex);
+    this->Cache.clear();
+    this->Hits   = 0;
+    this->Misses = 0;
+}
+
+//
+//  hits
+//
+// Return the number of lookups served from the cache
+//
+
+int WeightCache::hits() const
+{
+    QMutexLocker Locker(&this->Mutex);
+    return this->Hits;
+}
+
+//
+//  misses
+//
+// Return the number of tables computed
+//
+
+int WeightCache::misses() const
+{
+    QMutexLocker Locker(&this->Mutex);
+    return this->Misses;
+}
+
+//
+//  key
+//
+// Pack the parameters in 64 bits. QImage dimensions fit in 30 bits
+//
+
+quint64 WeightCache::key(int source, int target, Resampler::Filter filter)
+{
+    return (quint64(source & 0x3FFFFFFF) << 34) | (quint64(target & 0x3FFFFFFF) << 4) | quint64(filter & 0x0F);
+}
@@ -0,0 +1,66 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef WEIGHTCACHE_HPP
+#define WEIGHTCACHE_HPP
+
+#include "Resampler.hpp"
+#include <QCache>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QSize>
+
+//
+//  WeightCache
+//
+// This class is a thread-safe cache of the resampling coefficients, shared by all the resize workers.
+// Camera batches are made of pictures with the same size and the same new size: the weight tables
+// are computed for the first picture, then reused. Tables are cached per axis, keyed by
+// (source length, target length, filter), so a table is shared by both axes of square pictures too
+//
+
+class WeightCache
+{
+  public:
+    typedef QSharedPointer<const ResampleWeights> Weights;
+
+    static WeightCache* instance();                                                // Return the unique instance, created on first use
+    Weights             weights(int source, int target, Resampler::Filter filter); // Return the table of one axis, computing it if needed
+    void                clear();                                                   // Discard all the tables
+    int                 hits() const;                                              // Number of lookups served from the cache
+    int                 misses() const;                                            // Number of tables computed
+
+  private:
+    WeightCache();
+    static quint64 key(int source, int target, Resampler::Filter filter); // Pack the parameters in a single key
+
+    QCache<quint64, Weights> Cache;  // Cached tables. Cost is in KB
+    mutable QMutex           Mutex;  // Control access to the cache and counters
+    int                      Hits;   // Lookup statistics
+    int                      Misses; //
+};
+
+//
+//  Memory used by the cached tables, in KB
+//
+
+#define WEIGHT_CACHE_SIZE (16 * 1024)
+
+#endif // WEIGHTCACHE_HPP
@@ -0,0 +1,219 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "WorkerProcess.hpp"
+#include "BufferPool.hpp"
+#include "ResizeEngine.hpp"
+#include "ResourceGovernor.hpp"
+#include "StageMetrics.hpp"
+#include <QCoreApplication>
+#include <QFile>
+#include <QList>
+#include <QUrl>
+#include <cstdio>
+#include <cstring>
+
+//
+//  isWorker
+//
+// Return true if the program is started as a worker process
+//
+
+bool WorkerProcess::isWorker(int argc, char* argv[])
+{
+    return (argc > 1) && (std::strcmp(argv[1], WORKER_ARGUMENT) == 0);
+}
+
+//
+//  exec
+//
+// Entry point of a worker process. No GUI is created, but image plugins need an application object
+//
+
+int WorkerProcess::exec(int argc, char* argv[])
+{
+    QCoreApplication Application(argc, argv);
+    ResizeOptions    Options = parseArguments(QCoreApplication::arguments());
+    ResizeEngine     Engine(Options);
+    if (Options.Background) {
+        ResourceGovernor::lowerCurrentThread();
+    }
+
+    QFile Input;
+    QFile Output;
+    if (!Input.open(stdin, QIODevice::ReadOnly) || !Output.open(stdout, QIODevice::WriteOnly)) {
+        return 1;
+    }
+
+    for (QByteArray Line = Input.readLine(); !Line.isEmpty(); Line = Input.readLine()) {
+        ResizeJob Job;
+        if (!decodeJob(Line.trimmed(), Job)) {
+            continue;
+        }
+
+        QByteArray Id = QByteArray::number(Job.Id);
+        Output.write("S\t" + Id + "\n");
+        Output.flush();
+
+        ErrorRecords::Stage  Stage  = ErrorRecords::StageRead;
+        ErrorRecords::Reason Reason = ErrorRecords::ReasonNone;
+        Engine.resize(Job, &Stage, &Reason);
+
+        // Send the measures of the stages of the job. A job runs each stage at most once
+        StageStatistics Metrics = StageMetrics::instance()->take();
+        for (int i = 0; i < StageStatistics::StageCount; i++) {
+            StageStatistics::Stage Measured = StageStatistics::Stage(i);
+            if (Metrics.count(Measured) != 0) {
+                QList<QByteArray> Fields;
+                Fields << "M" << Id << QByteArray::number(i) << QByteArray::number(Metrics.nanoseconds(Measured));
+                Fields << QByteArray::number(Metrics.bytes(Measured)) << QByteArray::number(Metrics.pixels(Measured));
+                Output.write(Fields.join('\t') + '\n');
+            }
+        }
+        Output.write("D\t" + Id + "\t" + QByteArray::number(int(Reason)) + "\t" + QByteArray::number(int(Stage)) + "\n");
+        Output.flush();
+    }
+
+    return 0;
+}
+
+//
+//  arguments
+//
+// Build the command line giving the engine settings to each of the workers.
+// Parallelism settings are not passed: a worker processes one file at a time. The bandwidth caps are shared between the workers
+//
+
+QStringList WorkerProcess::arguments(const ResizeOptions& options, int workers)
+{
+    auto share = [workers](int bandwidth) { return bandwidth == 0 ? 0 : qMax(1, (bandwidth + workers - 1) / qMax(workers, 1)); };
+
+    QStringList Arguments;
+    Arguments << WORKER_ARGUMENT;
+    Arguments << "--filter" << Resampler::filterName(options.Filter);
+    Arguments << "--embedded-thumbnail" << QString::number(options.UseEmbeddedThumbnail);
+    Arguments << "--thumbnail-guard" << QString::number(options.ThumbnailQualityGuard);
+    Arguments << "--buffer-pool" << QString::number(options.BufferPoolSize);
+    Arguments << "--max-pixels" << QString::number(options.Limits.MaxPixels);
+    Arguments << "--allocation-limit" << QString::number(options.Limits.AllocationLimit);
+    Arguments << "--timeout" << QString::number(options.Limits.Timeout);
+    Arguments << "--background" << QString::number(options.Background);
+    Arguments << "--read-bandwidth" << QString::number(share(options.ReadBandwidth));
+    Arguments << "--write-bandwidth" << QString::number(share(options.WriteBandwidth));
+    Arguments << "--target-size" << QString::number(options.TargetSize);
+    Arguments << "--target-downscale" << QString::number(options.TargetDownscale);
+    Arguments << "--convert-srgb" << QString::number(options.ConvertToSrgb);
+    return Arguments;
+}
+
+//
+//  parseArguments
+//
+// Read the engine settings given by the main program. Unknown switches are ignored
+//
+
+ResizeOptions WorkerProcess::parseArguments(const QStringList& arguments)
+{
+    ResizeOptions Options;
+    for (int i = 1; i + 1 < arguments.count(); i++) {
+        const QString& Name  = arguments.at(i);
+        const QString& Value = arguments.at(i + 1);
+        if (Name == "--filter") {
+            Options.Filter = Resampler::filterFromName(Value, Options.Filter);
+        }
+        else if (Name == "--embedded-thumbnail") {
+            Options.UseEmbeddedThumbnail = Value.toInt() != 0;
+        }
+        else if (Name == "--thumbnail-guard") {
+            Options.ThumbnailQualityGuard = Value.toInt() != 0;
+        }
+        else if (Name == "--buffer-pool") {
+            Options.BufferPoolSize = qMax(Value.toInt(), 0);
+        }
+        else if (Name == "--max-pixels") {
+            Options.Limits.MaxPixels = Value.toLongLong();
+        }
+        else if (Name == "--allocation-limit") {
+            Options.Limits.AllocationLimit = Value.toInt();
+        }
+        else if (Name == "--timeout") {
+            Options.Limits.Timeout = qMax(Value.toInt(), 0);
+        }
+        else if (Name == "--background") {
+            Options.Background = Value.toInt() != 0;
+        }
+        else if (Name == "--read-bandwidth") {
+            Options.ReadBandwidth = qMax(Value.toInt(), 0);
+        }
+        else if (Name == "--write-bandwidth") {
+            Options.WriteBandwidth = qMax(Value.toInt(), 0);
+        }
+        else if (Name == "--target-size") {
+            Options.TargetSize = qMax(Value.toInt(), 0);
+        }
+        else if (Name == "--target-downscale") {
+            Options.TargetDownscale = Value.toInt() != 0;
+        }
+        else if (Name == "--convert-srgb") {
+            Options.ConvertToSrgb = Value.toInt() != 0;
+        }
+    }
+
+    BufferPool::instance()->setCapacity(qint64(Options.BufferPoolSize) * 1024 * 1024);
+    return Options;
+}
+
+//
+//  encodeJob
+//
+// Build the line sending a job to a worker
+//
+
+QByteArray WorkerProcess::encodeJob(const ResizeJob& job)
+{
+    QList<QByteArray> Fields;
+    Fields << "J" << QByteArray::number(job.Id);
+    Fields << QByteArray::number(job.OrgSize.width()) << QByteArray::number(job.OrgSize.height());
+    Fields << QByteArray::number(job.NewSize.width()) << QByteArray::number(job.NewSize.height());
+    Fields << QUrl::toPercentEncoding(job.Filename);
+    return Fields.join('\t') + '\n';
+}
+
+//
+//  decodeJob
+//
+// Parse a job line. Return false if the line is malformed
+//
+
+bool WorkerProcess::decodeJob(const QByteArray& line, ResizeJob& job)
+{
+    QList<QByteArray> Fields = line.split('\t');
+    if ((Fields.count() != 7) || (Fields.at(0) != "J")) {
+        return false;
+    }
+
+    bool Ok[5];
+    job.Id       = Fields.at(1).toInt(&Ok[0]);
+    job.OrgSize  = QSize(Fields.at(2).toInt(&Ok[1]), Fields.at(3).toInt(&Ok[2]));
+    job.NewSize  = QSize(Fields.at(4).toInt(&Ok[3]), Fields.at(5).toInt(&Ok[4]));
+    job.Filename = QUrl::fromPercentEncoding(Fields.at(6));
+
+    return Ok[0] && Ok[1] && Ok[2] && Ok[3] && Ok[4] && !job.Filename.isEmpty();
+}
@@ -0,0 +1,77 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef WORKERPROCESS_HPP
+#define WORKERPROCESS_HPP
+
+#include "ResizeJob.hpp"
+#include "ResizeOptions.hpp"
+#include <QByteArray>
+#include <QStringList>
+
+//
+//  WorkerProcess
+//
+// This class implements the worker processes used when resizing is isolated from the main program.
+// A worker is PicRes itself, started with --worker. It reads jobs on stdin, one per line, and resizes them one at a time.
+// It writes a line on stdout when a job starts and when it ends, so if an image plugin crashes the worker,
+// the main program knows which file is guilty.
+//
+// Protocol (tab-separated, file names are percent-encoded):
+//  main program -> worker: J <id> <org width> <org height> <new width> <new height> <filename>
+//  worker -> main program: S <id>                    job started
+//                          M <id> <stage> <ns> <bytes> <pixels>
+//                                                    measure of a stage of the job (StageStatistics::Stage), sent before D
+//                          D <id> <reason> <stage>   job done. Reason is 0 (ErrorRecords::ReasonNone) if it succeeded,
+//                                                    else the reason and the stage of the failure
+//
+
+class WorkerProcess
+{
+  public:
+    static bool        isWorker(int argc, char* argv[]);                     // Return true if the program is started as a worker
+    static int         exec(int argc, char* argv[]);                         // Entry point of a worker. Return when stdin is closed
+    static QStringList arguments(const ResizeOptions& options, int workers); // Command line giving the engine settings to each of the workers
+    static QByteArray  encodeJob(const ResizeJob& job);                      // Build the line sending a job to a worker
+    static bool        decodeJob(const QByteArray& line, ResizeJob& job);    // Parse a line sent to a worker
+
+  private:
+    static ResizeOptions parseArguments(const QStringList& arguments); // Read the engine settings of a worker
+};
+
+//
+//  Command line switch starting a worker process
+//
+
+#define WORKER_ARGUMENT "--worker"
+
+//
+//  Number of times in a row a worker may fail to start or die without processing a file before it's given up
+//
+
+#define WORKER_MAX_FAILURES 3
+
+//
+//  Interval at which the main program checks for cancellation and timeouts while workers are running, in ms
+//
+
+#define WORKER_POLLING_INTERVAL 100
+
+#endif // WORKERPROCESS_HPP
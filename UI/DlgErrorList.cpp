@@ -20,7 +20,9 @@
 
 #include "DlgErrorList.hpp"
 #include "../Global.hpp"
+#include "ErrorListModel.hpp"
 #include "ui_DlgErrorList.h"
+#include <QHeaderView>
 #include <QPushButton>
 
 //
@@ -29,7 +31,7 @@
 // Ctor
 //
 
-DlgErrorList::DlgErrorList(QString message, QStringList filenames, QWidget* parent)
+DlgErrorList::DlgErrorList(QString message, ErrorRecords records, QWidget* parent)
     : QDialog(parent)
     , ui(new Ui::DlgErrorList)
 {
@@ -37,12 +39,22 @@ DlgErrorList::DlgErrorList(QString message, QStringList filenames, QWidget* pare
     ui->setupUi(this);
     ui->LabelError->setText(message);                                 // Set the error message
     ui->verticalLayout->setAlignment(ui->ButtonOk, Qt::AlignHCenter); // Center the OK button
-    ui->ListInvalidFiles->addItems(filenames);                        // Add filenames to the list
+
+    // Show the files grouped by reason. Rows have the same height, so the view never measures the rows it doesn't display
+    ui->TreeErrors->setModel(new ErrorListModel(records, this));
+    ui->TreeErrors->setUniformRowHeights(true);
+    ui->TreeErrors->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    ui->TreeErrors->header()->setStretchLastSection(false);
+    ui->TreeErrors->header()->setSectionResizeMode(ERROR_COLUMN_FILENAME, QHeaderView::Stretch);
+    ui->TreeErrors->header()->setSectionResizeMode(ERROR_COLUMN_STAGE, QHeaderView::ResizeToContents);
+    if (records.count() <= ERROR_LIST_EXPAND_LIMIT) {
+        ui->TreeErrors->expandAll();
+    }
     setMinimumSize(size().width() * 2, size().height());              // Tweak the horizontal size to avoid a scrollable list widget
     setWindowTitle(MAIN_WINDOW_TITLE);
 
     // Connection
-    connect(ui->ButtonOk, &QPushButton::clicked, [this]() { accept(); }); // Connect the Ok button to close the dialog
+    connect(ui->ButtonOk, &QPushButton::clicked, [this]() { close(); }); // Connect the Ok button to close the dialog
 }
 
 //
@@ -59,12 +71,12 @@ DlgErrorList::~DlgErrorList()
 //
 //  openDlgErrorList
 //
-// Static method provided for conveniency
+// Static method provided for conveniency. The dialog is not modal, it's deleted when it's closed
 //
 
-void DlgErrorList::openDlgErrorList(QString message, QStringList filenames, QWidget* parent)
+void DlgErrorList::openDlgErrorList(QString message, ErrorRecords records, QWidget* parent)
 {
-    DlgErrorList* Dlg = new DlgErrorList(message, filenames, parent);
-    Dlg->exec();
-    delete Dlg;
+    DlgErrorList* Dlg = new DlgErrorList(message, records, parent);
+    Dlg->setAttribute(Qt::WA_DeleteOnClose);
+    Dlg->show();
 }
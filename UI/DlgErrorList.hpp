@@ -21,8 +21,9 @@
 #ifndef DLGERRORLIST_HPP
 #define DLGERRORLIST_HPP
 
+#include "../Core/ErrorLog.hpp"
 #include <QDialog>
-#include <QStringList>
+#include <QString>
 
 namespace Ui {
     class DlgErrorList;
@@ -31,7 +32,8 @@ namespace Ui {
 //
 //  DlgErrorList
 //
-// This class is a QDialog showing the list of files that couldn't be dropped or resized
+// This class is a QDialog showing the list of files that couldn't be dropped or resized, grouped by reason.
+// The dialog is modeless, so the program stays usable while the list is open
 //
 
 class DlgErrorList: public QDialog
@@ -39,13 +41,18 @@ class DlgErrorList: public QDialog
     Q_OBJECT
 
   public:
-    static void openDlgErrorList(QString message, QStringList filenames, QWidget* parent);
+    static void openDlgErrorList(QString message, ErrorRecords records, QWidget* parent);
 
   private:
-    DlgErrorList(QString message, QStringList filenames, QWidget* parent);
+    DlgErrorList(QString message, ErrorRecords records, QWidget* parent);
     ~DlgErrorList();
     Ui::DlgErrorList* ui;
 };
 
+//
+//  Largest number of files for which the groups are expanded when the dialog opens
+//
+
+#define ERROR_LIST_EXPAND_LIMIT 1000
 
 #endif // DLGERRORLIST_HPP
@@ -0,0 +1,227 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "ErrorListModel.hpp"
+#include <QFont>
+
+//
+//  ErrorListModel
+//
+// Constructor. Group the records by reason, in a single pass
+//
+
+ErrorListModel::ErrorListModel(const ErrorRecords& records, QObject* parent)
+    : QAbstractItemModel(parent)
+    , Records(records)
+{
+    QVector<int> GroupOfReason(ErrorRecords::ReasonCount, -1);
+    for (int i = 0; i < ErrorRecords::ReasonCount; i++) {
+        int Count = this->Records.count(ErrorRecords::Reason(i));
+        if (Count != 0) {
+            GroupOfReason[i] = this->Groups.count();
+            this->Reasons << ErrorRecords::Reason(i);
+            this->Groups << QVector<int>();
+            this->Groups.last().reserve(Count);
+        }
+    }
+
+    for (int i = 0; i < this->Records.count(); i++) {
+        int Group = GroupOfReason.value(this->Records.reason(i), -1);
+        if (Group != -1) {
+            this->Groups[Group] << i;
+        }
+    }
+}
+
+//
+//  index
+//
+// Top-level rows are the groups, their internal id is 0. Files have the group index + 1 as internal id
+//
+
+QModelIndex ErrorListModel::index(int row, int column, const QModelIndex& parent) const
+{
+    if ((row < 0) || (column < 0) || (column >= ERROR_COLUMN_COUNT)) {
+        return QModelIndex();
+    }
+    if (!parent.isValid()) {
+        return row < this->Groups.count() ? createIndex(row, column, quintptr(0)) : QModelIndex();
+    }
+    if ((parent.internalId() == 0) && (row < this->Groups.at(parent.row()).count())) {
+        return createIndex(row, column, quintptr(parent.row() + 1));
+    }
+    return QModelIndex();
+}
+
+//
+//  parent
+//
+// Return the group of a file, or nothing for a group
+//
+
+QModelIndex ErrorListModel::parent(const QModelIndex& index) const
+{
+    if (!index.isValid() || (index.internalId() == 0)) {
+        return QModelIndex();
+    }
+    return createIndex(int(index.internalId() - 1), 0, quintptr(0));
+}
+
+//
+//  rowCount
+//
+// Return the number of groups, or the number of files of a group
+//
+
+int ErrorListModel::rowCount(const QModelIndex& parent) const
+{
+    if (!parent.isValid()) {
+        return this->Groups.count();
+    }
+    if ((parent.internalId() == 0) && (parent.column() == 0)) {
+        return this->Groups.at(parent.row()).count();
+    }
+    return 0;
+}
+
+//
+//  columnCount
+//
+// Return the number of columns: file and stage
+//
+
+int ErrorListModel::columnCount(const QModelIndex&) const
+{
+    return ERROR_COLUMN_COUNT;
+}
+
+//
+//  data
+//
+// Groups are displayed in bold with their file count. Files show their path and the stage at which they failed
+//
+
+QVariant ErrorListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    // Group
+    if (index.internalId() == 0) {
+        if ((role == Qt::DisplayRole) && (index.column() == ERROR_COLUMN_FILENAME)) {
+            int Group = index.row();
+            return QString("%1 (%2)").arg(reasonText(this->Reasons.at(Group))).arg(this->Groups.at(Group).count());
+        }
+        if (role == Qt::FontRole) {
+            QFont Font;
+            Font.setBold(true);
+            return Font;
+        }
+        return QVariant();
+    }
+
+    // File
+    int Record = this->Groups.at(int(index.internalId() - 1)).at(index.row());
+    if ((role == Qt::DisplayRole) || (role == Qt::ToolTipRole)) {
+        if (index.column() == ERROR_COLUMN_FILENAME) {
+            return this->Records.filename(Record);
+        }
+        if (index.column() == ERROR_COLUMN_STAGE) {
+            return stageText(this->Records.stage(Record));
+        }
+    }
+    return QVariant();
+}
+
+//
+//  headerData
+//
+// Return the titles of the columns
+//
+
+QVariant ErrorListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation != Qt::Horizontal) || (role != Qt::DisplayRole)) {
+        return QVariant();
+    }
+    switch (section) {
+        case ERROR_COLUMN_FILENAME:
+            return tr("File");
+        case ERROR_COLUMN_STAGE:
+            return tr("Stage");
+    }
+    return QVariant();
+}
+
+//
+//  reasonText
+//
+// Return the title of the group of a reason
+//
+
+QString ErrorListModel::reasonText(ErrorRecords::Reason reason)
+{
+    switch (reason) {
+        case ErrorRecords::ReasonUnreadable:
+            return tr("Couldn't be opened");
+        case ErrorRecords::ReasonTooLarge:
+            return tr("Too large (per-file limits)");
+        case ErrorRecords::ReasonTimeout:
+            return tr("Took too long (per-file timeout)");
+        case ErrorRecords::ReasonDecodeFailed:
+            return tr("Couldn't be decoded");
+        case ErrorRecords::ReasonEncodeFailed:
+            return tr("Couldn't be encoded");
+        case ErrorRecords::ReasonWriteFailed:
+            return tr("Couldn't be written");
+        case ErrorRecords::ReasonCrashed:
+            return tr("Crashed the image decoder");
+        case ErrorRecords::ReasonNotProcessed:
+            return tr("Not processed");
+        case ErrorRecords::ReasonNone:
+        case ErrorRecords::ReasonCount:
+            break;
+    }
+    return ErrorRecords::reasonName(reason);
+}
+
+//
+//  stageText
+//
+// Return the name of a stage
+//
+
+QString ErrorListModel::stageText(ErrorRecords::Stage stage)
+{
+    switch (stage) {
+        case ErrorRecords::StageDrop:
+            return tr("Drop");
+        case ErrorRecords::StageRead:
+            return tr("Read");
+        case ErrorRecords::StageProcess:
+            return tr("Decode/resize/encode");
+        case ErrorRecords::StageWrite:
+            return tr("Write");
+        case ErrorRecords::StageQueue:
+            return tr("Queue");
+    }
+    return ErrorRecords::stageName(stage);
+}
@@ -0,0 +1,72 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef ERRORLISTMODEL_HPP
+#define ERRORLISTMODEL_HPP
+
+#include "../Core/ErrorLog.hpp"
+#include <QAbstractItemModel>
+#include <QModelIndex>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+//
+//  Column index
+//
+
+#define ERROR_COLUMN_FILENAME 0
+#define ERROR_COLUMN_STAGE    1
+#define ERROR_COLUMN_COUNT    2
+
+//
+//  ErrorListModel
+//
+// This class is the model displayed by the error dialog. Failed files are grouped by reason: each group is a top-level row,
+// titled with the reason and the number of files, and the files are its children.
+// Records are not copied: the model only keeps, for each group, the indexes of its records.
+// Views ask for the visible rows only, so the dialog opens at once even with hundreds of thousands of files
+//
+
+class ErrorListModel: public QAbstractItemModel
+{
+    Q_OBJECT
+
+  public:
+    explicit ErrorListModel(const ErrorRecords& records, QObject* parent = nullptr);
+
+    // QAbstractItemModel interface
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& index) const override;
+    int         rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int         columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant    data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant    headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    static QString reasonText(ErrorRecords::Reason reason); // Title of the group of a reason, displayed to the user
+    static QString stageText(ErrorRecords::Stage stage);    // Name of a stage, displayed to the user
+
+  private:
+    ErrorRecords                  Records; // Failed files
+    QVector<ErrorRecords::Reason> Reasons; // Reason of each group, in display order
+    QVector<QVector<int>>         Groups;  // Record indexes of each group
+};
+
+#endif // ERRORLISTMODEL_HPP
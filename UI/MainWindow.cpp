@@ -20,22 +20,29 @@
 
 #include "MainWindow.hpp"
 #include "../Core/DropThread.hpp"
+#include "../Core/FileWalker.hpp"
+#include "../Core/JobJournal.hpp"
+#include "../Core/ResizeOptions.hpp"
+#include "../Core/ResizeParameters.hpp"
 #include "../Core/ResizeThread.hpp"
+#include "../Core/SessionFile.hpp"
+#include "../Core/ThumbnailThread.hpp"
 #include "../Global.hpp"
 #include "DlgErrorList.hpp"
 #include "DlgHelp.hpp"
-#include "TableItem.hpp"
+#include "TableModel.hpp"
 #include "ui_MainWindow.h"
 #include <QAbstractItemView>
 #include <QCoreApplication>
-#include <QDir>
+#include <QFileDialog>
 #include <QFileInfo>
+#include <QHash>
 #include <QHeaderView>
-#include <QImageReader>
 #include <QMessageBox>
+#include <QPair>
 #include <QPushButton>
 #include <QRadioButton>
-#include <QVariant>
+#include <QSettings>
 #include <QVBoxLayout>
 
 //
@@ -46,9 +53,10 @@
 
 MainWindow::MainWindow(int argc, char* argv[])
     : ui(new Ui::MainWindow)
-    , Table(new QTableWidget)
-    , SupportedExtensionList(QImageReader::supportedImageFormats())
+    , Table(new QTableView)
+    , Model(new TableModel(this))
     , CloseRequested(false)
+    , ResizeOnDrop(QSettings().value("Resize/ResizeOnDrop", false).toBool())
 {
     //
     //  UI
@@ -61,6 +69,7 @@ MainWindow::MainWindow(int argc, char* argv[])
     centralWidget()->layout()->setAlignment(ui->ButtonResize, Qt::AlignHCenter);
     ui->HLayoutPercentage->setAlignment(ui->SpinboxPercentage, Qt::AlignHCenter);
     ui->HLayoutAbsoluteSize->setAlignment(ui->SpinboxAbsoluteSize, Qt::AlignHCenter);
+    ui->HLayoutTargetSize->setAlignment(ui->SpinboxTargetSize, Qt::AlignHCenter);
     ui->HLayoutProgress->setAlignment(Qt::AlignRight);
     ui->BoxDrop->layout()->setAlignment(Qt::AlignCenter);
 
@@ -70,12 +79,10 @@ MainWindow::MainWindow(int argc, char* argv[])
 
     // Configure the table displaying the dropped files
     // The table is created here and not with the WYSIWYG tool, because I prefer to configure it by hand
-    QStringList Labels;
-    Labels << "File name"
-           << "Actual size"
-           << "New size";
+    // New sizes are computed by the model when they are displayed, using the current resizing method
+    this->Model->setResizeParameters(resizeParameters());
 
-    this->Table->setColumnCount(COLUMN_COUNT);
+    this->Table->setModel(this->Model);
     this->Table->setShowGrid(true);
     this->Table->setSortingEnabled(true);
     this->Table->setAlternatingRowColors(true);
@@ -84,8 +91,28 @@ MainWindow::MainWindow(int argc, char* argv[])
     this->Table->setSelectionBehavior(QAbstractItemView::SelectRows);
     this->Table->horizontalHeader()->setStretchLastSection(true);
     this->Table->verticalHeader()->setVisible(false);
-    this->Table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
-    this->Table->setHorizontalHeaderLabels(Labels);
+    // Don't resize sections to their contents, that would format every row of huge tables
+    this->Table->horizontalHeader()->setSectionResizeMode(COLUMN_FILENAME, QHeaderView::Interactive);
+    this->Table->horizontalHeader()->setDefaultSectionSize(150);
+    this->Table->horizontalHeader()->resizeSection(COLUMN_FILENAME, 500);
+    this->Table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+
+    // Thumbnails are loaded asynchronously by the model, for the visible rows only
+    this->Table->setIconSize(QSize(THUMBNAIL_SIZE, THUMBNAIL_SIZE));
+    this->Table->verticalHeader()->setDefaultSectionSize(THUMBNAIL_SIZE + 4);
+    this->Table->horizontalHeader()->resizeSection(COLUMN_THUMBNAIL, THUMBNAIL_SIZE + 8);
+    this->Table->horizontalHeader()->setSectionResizeMode(COLUMN_THUMBNAIL, QHeaderView::Fixed);
+    ThumbnailThread::instance()->setDiskCacheEnabled(QSettings().value("Thumbnails/DiskCache", false).toBool());
+
+    // The file size budget of the settings is the initial one
+    int TargetSize = ResizeOptions::fromSettings().TargetSize;
+    if (TargetSize != 0) {
+        ui->SpinboxTargetSize->setValue(TargetSize);
+    }
+    ui->CheckboxTargetSize->setChecked(TargetSize != 0);
+
+    // Failed files are also written to a log file as soon as they fail, if one is set
+    ErrorLog::setLogFile(QSettings().value("Errors/LogFile").toString());
 
     // Insert between the tip label and the progress bar
     ui->VLayoutDrop->insertWidget(1, this->Table);
@@ -96,26 +123,36 @@ MainWindow::MainWindow(int argc, char* argv[])
     //  Data
     //
 
-    // Remove extensions supported only in read-only mode by Qt
-    this->SupportedExtensionList.removeOne("GIF");
-    this->SupportedExtensionList.removeOne("PBM");
-    this->SupportedExtensionList.removeOne("PGM");
+    // Image plugins are not queried here: they are loaded when the first file is read, so the window shows up at once.
+    // The list of readable formats is provided by ImageFormats, which caches it between sessions
+
+    // Parameter changes are applied once the user stops changing them, so holding a spinbox arrow stays smooth
+    this->ParametersTimer.setSingleShot(true);
+    this->ParametersTimer.setInterval(100);
 
     //
     //  Connections
     //
 
+    // Apply resizing parameters when they are stable
+    connect(&this->ParametersTimer, &QTimer::timeout, [this]() { updateAllSizes(); });
+
     // Enable/disable the spinboxes according to the checked radio buttons. Force new size update
-    connect(ui->RadioPercentage, &QRadioButton::clicked, [this]() { updateAllSizes(); });
-    connect(ui->RadioAbsoluteSize, &QRadioButton::clicked, [this]() { updateAllSizes(); });
+    connect(ui->RadioPercentage, &QRadioButton::clicked, [this]() { scheduleSizesUpdate(); });
+    connect(ui->RadioAbsoluteSize, &QRadioButton::clicked, [this]() { scheduleSizesUpdate(); });
 
     // Connect the spinboxes to update the new size
     connect(ui->SpinboxPercentage, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), [this]() { onPercentageValueChanged(); });
     connect(ui->SpinboxAbsoluteSize, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), [this]() { onAbsoluteValueChanged(); });
 
+    // Changing the file size budget enables it. It doesn't change the new sizes
+    connect(ui->SpinboxTargetSize, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), [this]() { ui->CheckboxTargetSize->setChecked(true); });
+
     // Connect other buttons
     connect(ui->ButtonResize, &QPushButton::clicked, [this]() { onButtonResizeClicked(); });
     connect(ui->ButtonClearList, &QPushButton::clicked, [this]() { clearTable(); });
+    connect(ui->ButtonSaveList, &QPushButton::clicked, [this]() { saveList(); });
+    connect(ui->ButtonLoadList, &QPushButton::clicked, [this]() { loadList(); });
     connect(ui->ButtonCancel, &QPushButton::clicked, [this]() { cancelTask(); });
     connect(ui->ButtonHelp, &QPushButton::clicked, [this]() { DlgHelp::openDlgHelp(this); });
 
@@ -144,6 +181,10 @@ MainWindow::MainWindow(int argc, char* argv[])
         // Force file handling
         onPicturesDropped(Urls);
     }
+    else {
+        // Once the window is shown, offer to finish the work of an interrupted run
+        QTimer::singleShot(0, this, [this]() { offerResume(); });
+    }
 }
 
 //
@@ -157,6 +198,7 @@ MainWindow::~MainWindow()
     delete ui;
     delete DropThread::instance();
     delete ResizeThread::instance();
+    ThumbnailThread::release();
 }
 
 //
@@ -169,7 +211,7 @@ MainWindow::~MainWindow()
 void MainWindow::updateUI()
 {
     // Shortcuts for common properties
-    int  ItemCount             = this->Table->rowCount();
+    int  ItemCount             = this->Model->rowCount();
     bool TableIsEmpty          = ItemCount == 0;
     bool DropThreadIsRunning   = DropThread::instance()->isRunning();
     bool ResizeThreadIsRunning = ResizeThread::instance()->isRunning();
@@ -182,7 +224,11 @@ void MainWindow::updateUI()
     ui->RadioAbsoluteSize->setDisabled(TableIsEmpty || ResizeThreadIsRunning);   // Resizing methods are disabled if the table is empty
     ui->SpinboxPercentage->setDisabled(TableIsEmpty || ResizeThreadIsRunning);   // Resizing methods are disabled if the table is empty
     ui->SpinboxAbsoluteSize->setDisabled(TableIsEmpty || ResizeThreadIsRunning); // Resizing methods are disabled if the table is empty
+    ui->CheckboxTargetSize->setDisabled(ResizeThreadIsRunning);                  // The file size budget is given to the resizing process when it starts
+    ui->SpinboxTargetSize->setDisabled(ResizeThreadIsRunning);                   // The file size budget is given to the resizing process when it starts
     ui->ButtonClearList->setVisible(!TableIsEmpty && !AThreadIsRunning);         // Can't clear the list if it's empty or in use
+    ui->ButtonSaveList->setVisible(!TableIsEmpty && !AThreadIsRunning);          // Can't save the list if it's empty or in use
+    ui->ButtonLoadList->setVisible(!AThreadIsRunning);                           // Can't load a list while it's in use
     ui->ButtonCancel->setVisible(AThreadIsRunning);                              // Cancel button is visible only if a process is running
     ui->ButtonResize->setEnabled(!TableIsEmpty && !AThreadIsRunning);            // We can resize when there is something to resize and no thread is working
     ui->ButtonClearList->setText(tr("Clear list (%1 items)").arg(ItemCount));    // Display the size of the table in the Clear button
@@ -202,8 +248,8 @@ void MainWindow::updateUI()
 
 void MainWindow::onPicturesDropped(QList<QUrl> url)
 {
-    // Prevent drops during resizing
-    if (ResizeThread::instance()->isRunning()) {
+    // Prevent drops during resizing, unless the dropped files are resized on the fly
+    if (ResizeThread::instance()->isRunning() && !this->ResizeOnDrop) {
         QMessageBox::critical(this, MAIN_WINDOW_TITLE, tr("Cannot drop files while resizing."), QMessageBox::Ok);
         return;
     }
@@ -216,32 +262,21 @@ void MainWindow::onPicturesDropped(QList<QUrl> url)
             FileUrl << url.at(i);
         }
         else if (Info.isDir()) {
-            getFiles(FileUrl, url.at(i));
+            QStringList Files;
+            FileWalker::getFiles(Files, Info.absoluteFilePath(), false);
+            for (const QString& File : Files) {
+                FileUrl << QUrl::fromLocalFile(File);
+            }
         }
     }
 
+    DropThread::instance()->setLimits(ImageLimits::fromSettings());
     DropThread::instance()->drop(FileUrl);
 
     ui->ProgressBar->setMaximum(ui->ProgressBar->maximum() + FileUrl.count());
     updateUI();
 }
 
-void MainWindow::getFiles(QList<QUrl>& list, QUrl dirurl) const
-{
-    QDir          Directory(dirurl.toLocalFile());
-    QFileInfoList InfoList(Directory.entryInfoList(QDir::AllEntries | QDir::NoDot | QDir::NoDotDot, QDir::Name | QDir::DirsFirst));
-
-    for (int i = 0; i < InfoList.count(); i++) {
-        QUrl URL(QUrl::fromLocalFile(InfoList.at(i).absoluteFilePath()));
-        if (InfoList.at(i).isFile()) {
-            list.append(URL);
-        }
-        else {
-            getFiles(list, URL);
-        }
-    }
-}
-
 //
 //  onDropResultReady
 //
@@ -252,54 +287,33 @@ void MainWindow::getFiles(QList<QUrl>& list, QUrl dirurl) const
 void MainWindow::onDropResultReady()
 {
     QList<QPair<QString, QSize>> Result;
-    DropThread::instance()->result(&Result);
+    QStringList                  Oversized;
+    DropThread::instance()->result(&Result, &Oversized);
+    for (const QString& Filename : Oversized) {
+        this->DropErrors.append(Filename, ErrorRecords::StageDrop, ErrorRecords::ReasonTooLarge);
+    }
 
+    // Add the files to the table if they could be read, else add them to the error list
+    // Files already present are discarded by the model without any warning message
+    QList<QPair<QString, QSize>> ValidFiles;
+    ValidFiles.reserve(Result.size());
     for (int i = 0; i < Result.size(); i++) {
-        QString Filename = Result.at(i).first;
-        QSize   OrgSize  = Result.at(i).second;
-
-        // Check that the file is not added yet. If so, discard it without any warning message
-        bool AlreadyPresent = false;
-        for (int i = 0; i < this->Table->rowCount(); i++) {
-            if (Filename == this->Table->item(i, COLUMN_FILENAME)->text()) {
-                AlreadyPresent = true;
-                break;
-            }
-        }
-        if (AlreadyPresent) {
-            continue;
-        }
-
-        // Add the file to the table if it could be read, else add it to the error list
-        if (OrgSize.isValid()) {
-            // Compute new size
-            QSize NewSize;
-            updateSize(OrgSize, NewSize);
-
-            // Create the items to add. Use a QTableWidgetItem for the filename, because we don't want it to be centered
-            // Store related data in dedicated locations
-            QTableWidgetItem* ItemName = new QTableWidgetItem(Filename);
-
-            TableItem* ItemOrgSize = new TableItem(QString("%1 x %2").arg(OrgSize.width()).arg(OrgSize.height()));
-            ItemOrgSize->setData(Qt::UserRole, QVariant::fromValue(OrgSize));
-
-            TableItem* ItemNewSize = new TableItem(QString("%1 x %2").arg(NewSize.width()).arg(NewSize.height()));
-            ItemNewSize->setData(Qt::UserRole, QVariant::fromValue(NewSize));
-
-            // Populate the table
-            int Row = this->Table->rowCount();
-            this->Table->insertRow(Row);
-            this->Table->setItem(Row, COLUMN_FILENAME, ItemName);
-            this->Table->setItem(Row, COLUMN_ORGSIZE, ItemOrgSize);
-            this->Table->setItem(Row, COLUMN_NEWSIZE, ItemNewSize);
+        if (Result.at(i).second.isValid()) {
+            ValidFiles << Result.at(i);
         }
         else {
-            this->InvalidDroppedFiles << Filename;
+            this->DropErrors.append(Result.at(i).first, ErrorRecords::StageDrop, ErrorRecords::ReasonUnreadable);
         }
     }
+    this->Model->append(ValidFiles);
+
+    // In streaming mode, the files are resized as soon as they have been probed
+    if (this->ResizeOnDrop && !ValidFiles.isEmpty()) {
+        enqueueNewJobs();
+    }
 
     // Update UI only if the list contains data
-    if (Result.count() != 0) {
+    if ((Result.count() != 0) || (Oversized.count() != 0)) {
         updateUI();
     }
 
@@ -327,15 +341,51 @@ void MainWindow::onDroppedFileProcessed(QString filename)
 
 void MainWindow::onDropProcessTerminated()
 {
-    // Display invalid files if a problem occured, then clear the list
-    if (!this->InvalidDroppedFiles.isEmpty()) {
-        DlgErrorList::openDlgErrorList(tr("Some files couldn't be opened:"), this->InvalidDroppedFiles, this);
-        this->InvalidDroppedFiles.clear();
+    // Display invalid files if a problem occured, then clear the lists
+    ErrorLog::flushLogFile();
+    if (!this->DropErrors.isEmpty()) {
+        DlgErrorList::openDlgErrorList(tr("Some files couldn't be added:"), this->DropErrors.records(), this);
+        this->DropErrors.clear();
+    }
+
+    // All dropped files have been enqueued: the streaming process can terminate once they are resized
+    if (this->ResizeOnDrop) {
+        ResizeThread::instance()->closeInput();
     }
 
     updateUI();
 }
 
+//
+//  enqueueNewJobs
+//
+// Streaming mode: resize the files which have not been queued yet, without asking for confirmation.
+// They are given to the running process, or start a new one. If the running process is already terminating,
+// they are kept until it's done. The input of the process stays open while files are being probed.
+// The table gets the resizing parameters only if they were changed: the new rows are the only ones given a size
+//
+
+void MainWindow::enqueueNewJobs()
+{
+    if (this->ParametersTimer.isActive()) {
+        this->ParametersTimer.stop();
+        updateAllSizes();
+    }
+    QList<ResizeJob> Jobs = this->Model->queueJobs(true);
+    if (Jobs.isEmpty()) {
+        return;
+    }
+
+    ResizeThread* Thread = ResizeThread::instance();
+    if (!Thread->isRunning()) {
+        Thread->resize(Jobs, resizeOptions(), DropThread::instance()->isRunning());
+    }
+    else if (!Thread->enqueue(Jobs)) {
+        this->StreamBacklog << Jobs;
+    }
+    ui->ProgressBar->setMaximum(ui->ProgressBar->maximum() + Jobs.count());
+}
+
 //
 //  onButtonResizeClicked
 //
@@ -347,29 +397,65 @@ void MainWindow::onButtonResizeClicked()
     if (QMessageBox::warning(this, MAIN_WINDOW_TITLE, tr("Original pictures will be overwritten. Do you want to continue?"), QMessageBox::Yes | QMessageBox::No)
         == QMessageBox::Yes) {
 
-        // Build the list of files to resize
-        QList<QPair<QString, QSize>> Files;
-        for (int i = 0; i < this->Table->rowCount(); i++) {
-            QString Filename = this->Table->item(i, COLUMN_FILENAME)->text();
-            QSize   Size     = this->Table->item(i, COLUMN_NEWSIZE)->data(Qt::UserRole).toSize();
-            Files << QPair<QString, QSize>(Filename, Size);
-        }
+        // Apply a pending parameter change, then build the list of files to resize. New sizes are materialized here only
+        this->ParametersTimer.stop();
+        updateAllSizes();
+        QList<ResizeJob> Jobs = this->Model->queueJobs();
 
         // Start the thread and set UI
-        ResizeThread::instance()->resize(Files);
-        ui->ProgressBar->setMaximum(this->Table->rowCount());
+        ResizeThread::instance()->resize(Jobs, resizeOptions());
+        ui->ProgressBar->setMaximum(this->Model->rowCount());
         updateUI();
     }
 }
 
+//
+//  offerResume
+//
+// If the previous run was interrupted, offer to resize the files it left, with the new sizes they were given.
+// They are added to the table without being probed again. If the user declines, the journal of the previous run is discarded
+//
+
+void MainWindow::offerResume()
+{
+    QList<ResizeJob> Jobs = JobJournal::instance()->unfinishedJobs();
+    if (Jobs.isEmpty()) {
+        return;
+    }
+    if (QMessageBox::question(this, MAIN_WINDOW_TITLE, tr("%1 pictures were not resized when PicRes stopped. Do you want to resize them now?").arg(Jobs.count()), QMessageBox::Yes | QMessageBox::No)
+        != QMessageBox::Yes) {
+        JobJournal::instance()->discard();
+        return;
+    }
+
+    // The table gives its own ids to the files
+    QList<QPair<QString, QSize>> Files;
+    QHash<QString, QSize>        NewSizes;
+    for (const ResizeJob& Job : Jobs) {
+        Files << qMakePair(Job.Filename, Job.OrgSize);
+        NewSizes[Job.Filename] = Job.NewSize;
+    }
+    this->Model->append(Files);
+
+    QList<ResizeJob> Resumed = this->Model->queueJobs();
+    for (ResizeJob& Job : Resumed) {
+        Job.NewSize = NewSizes.value(Job.Filename, Job.NewSize);
+    }
+    ResizeThread::instance()->resize(Resumed, resizeOptions());
+    ui->ProgressBar->setMaximum(this->Model->rowCount());
+    updateUI();
+}
+
 //
 //  onFileResizing
 //
 // Triggered when the resizer thread starts to process a file. Update UI according to
 //
 
-void MainWindow::onFileResizing(QString filename)
+void MainWindow::onFileResizing(int id, QString filename)
 {
+    this->Model->setJobStatus(id, FileStore::StatusRunning);
+
     // Display file related information in the progress bar
     ui->ProgressBar->setValue(ui->ProgressBar->value() + 1);
     ui->ProgressBar->setFormat(QString("%1 (%p%)").arg(filename));
@@ -378,12 +464,13 @@ void MainWindow::onFileResizing(QString filename)
 //
 //  onFileResized
 //
-// Triggered when a file has been processed
+// Triggered when a file has been processed. The job id identifies the file, whatever its position in the table.
+// Done rows are removed by the model in batches, so the cost per file stays constant
 //
 
-void MainWindow::onFileResized()
+void MainWindow::onFileResized(int id, bool success)
 {
-    this->Table->removeRow(0);
+    this->Model->setJobStatus(id, success ? FileStore::StatusDone : FileStore::StatusFailed);
 }
 
 //
@@ -395,13 +482,27 @@ void MainWindow::onFileResized()
 
 void MainWindow::onResizingTerminated()
 {
+    this->Model->flushJobs();
+    ErrorRecords Errors = ResizeThread::instance()->errors();
+
+    // Streaming mode: files dropped while the process was terminating are resized by a new one.
+    // Report only the errors, a success message would pop up at every drop
+    if (!this->StreamBacklog.isEmpty() && !this->CloseRequested) {
+        ResizeThread::instance()->resize(this->StreamBacklog, resizeOptions(), DropThread::instance()->isRunning());
+        this->StreamBacklog.clear();
+        if (!Errors.isEmpty()) {
+            DlgErrorList::openDlgErrorList(tr("Some files couldn't be resized"), Errors, this);
+        }
+        updateUI();
+        return;
+    }
+
     if (!this->CloseRequested) {
-        QStringList Files = ResizeThread::instance()->invalidFiles();
-        if (Files.isEmpty()) {
+        if (Errors.isEmpty()) {
             QMessageBox::information(this, MAIN_WINDOW_TITLE, tr("All files successfully resized!"), QMessageBox::Ok);
         }
         else {
-            DlgErrorList::openDlgErrorList(tr("Some files couldn't be resized"), Files, this);
+            DlgErrorList::openDlgErrorList(tr("Some files couldn't be resized"), Errors, this);
         }
 
         updateUI();
@@ -417,13 +518,15 @@ void MainWindow::onResizingTerminated()
 
 void MainWindow::onResizingAborted()
 {
+    this->StreamBacklog.clear();
+    this->Model->resetJobs();
     if (!this->CloseRequested) {
-        QStringList Files = ResizeThread::instance()->invalidFiles();
-        if (Files.isEmpty()) {
+        ErrorRecords Errors = ResizeThread::instance()->errors();
+        if (Errors.isEmpty()) {
             QMessageBox::warning(this, MAIN_WINDOW_TITLE, tr("Resizing process interrupted by user."), QMessageBox::Ok);
         }
         else {
-            DlgErrorList::openDlgErrorList(tr("Resizing process interrupted by user. Some files couldn't be resized."), Files, this);
+            DlgErrorList::openDlgErrorList(tr("Resizing process interrupted by user. Some files couldn't be resized."), Errors, this);
         }
 
         updateUI();
@@ -439,7 +542,7 @@ void MainWindow::onResizingAborted()
 void MainWindow::onPercentageValueChanged()
 {
     ui->RadioPercentage->setChecked(true);
-    updateAllSizes();
+    scheduleSizesUpdate();
 }
 
 //
@@ -451,56 +554,55 @@ void MainWindow::onPercentageValueChanged()
 void MainWindow::onAbsoluteValueChanged()
 {
     ui->RadioAbsoluteSize->setChecked(true);
-    updateAllSizes();
+    scheduleSizesUpdate();
+}
+
+//
+//  scheduleSizesUpdate
+//
+// (Re)start the debounce timer. New sizes are updated when the parameters stop changing
+//
+
+void MainWindow::scheduleSizesUpdate()
+{
+    this->ParametersTimer.start();
 }
 
 //
 //  updateAllSizes
 //
-// Compute and display the new picture sizes, depending on the current resizing method
+// Give the current resizing method to the table. Only the visible new sizes are computed and displayed
 //
 
 void MainWindow::updateAllSizes()
 {
-    for (int i = 0; i < this->Table->rowCount(); i++) {
-        QSize OrgSize = this->Table->item(i, COLUMN_ORGSIZE)->data(Qt::UserRole).toSize();
-        QSize NewSize;
-        updateSize(OrgSize, NewSize);
-        this->Table->item(i, COLUMN_NEWSIZE)->setText(QString("%1 x %2").arg(NewSize.width()).arg(NewSize.height()));
-        this->Table->item(i, COLUMN_NEWSIZE)->setData(Qt::UserRole, QVariant::fromValue(NewSize));
-    }
+    this->Model->setResizeParameters(resizeParameters());
 }
 
 //
-//  updateSize
+//  resizeParameters
 //
-// Update the given size according to the selected resizing method
+// Return the resizing method and values selected in the UI
 //
 
-void MainWindow::updateSize(QSize& orgsize, QSize& newsize)
+ResizeParameters MainWindow::resizeParameters() const
 {
-    // Percentage method selected
-    if (ui->RadioPercentage->isChecked()) {
-        int Percentage = ui->SpinboxPercentage->value();
-        newsize.setWidth((orgsize.width() * Percentage) / 100);
-        newsize.setHeight((orgsize.height() * Percentage) / 100);
-    }
-    // Absolute Size method selected
-    else {
-        int MaxSize = ui->SpinboxAbsoluteSize->value();
-        if (orgsize.width() > orgsize.height()) {
-            newsize.setHeight((orgsize.height() * MaxSize) / orgsize.width());
-            newsize.setWidth(MaxSize);
-        }
-        else {
-            newsize.setWidth((orgsize.width() * MaxSize) / orgsize.height());
-            newsize.setHeight(MaxSize);
-        }
-    }
+    return ResizeParameters(ui->RadioPercentage->isChecked() ? ResizeParameters::MethodPercentage : ResizeParameters::MethodAbsoluteSize,
+                            ui->SpinboxPercentage->value(),
+                            ui->SpinboxAbsoluteSize->value());
+}
 
-    // Prevent from getting a null size
-    newsize.setWidth(max(newsize.width(), 1));
-    newsize.setHeight(max(newsize.height(), 1));
+//
+//  resizeOptions
+//
+// Return the engine settings, with the file size budget selected in the UI
+//
+
+ResizeOptions MainWindow::resizeOptions() const
+{
+    ResizeOptions Options = ResizeOptions::fromSettings();
+    Options.TargetSize    = ui->CheckboxTargetSize->isChecked() ? ui->SpinboxTargetSize->value() : 0;
+    return Options;
 }
 
 //
@@ -511,11 +613,72 @@ void MainWindow::updateSize(QSize& orgsize, QSize& newsize)
 
 void MainWindow::clearTable()
 {
-    Table->clearContents();
-    Table->setRowCount(0);
+    this->Model->clear();
     updateUI();
 }
 
+//
+//  saveList
+//
+// Save the table and the resizing method to a session file, so a recurring job can be reloaded without scanning and probing
+//
+
+void MainWindow::saveList()
+{
+    QString Filename = QFileDialog::getSaveFileName(this, tr("Save the list"), QString(), tr("PicRes lists (*.%1)").arg(SESSION_EXTENSION));
+    if (Filename.isEmpty()) {
+        return;
+    }
+    if (QFileInfo(Filename).suffix().isEmpty()) {
+        Filename += "." SESSION_EXTENSION;
+    }
+
+    // Apply a pending parameter change, so the saved method is the displayed one
+    this->ParametersTimer.stop();
+    updateAllSizes();
+
+    QString Error;
+    if (!this->Model->saveSession(Filename, &Error)) {
+        QMessageBox::critical(this, MAIN_WINDOW_TITLE, tr("Couldn't save the list: %1").arg(Error), QMessageBox::Ok);
+    }
+}
+
+//
+//  loadList
+//
+// Add the files of a session file to the table, without probing them, and restore the resizing method of the session.
+// Unless disabled in the settings, the files which don't exist anymore are skipped
+//
+
+void MainWindow::loadList()
+{
+    QString Filename = QFileDialog::getOpenFileName(this, tr("Load a list"), QString(), tr("PicRes lists (*.%1)").arg(SESSION_EXTENSION));
+    if (Filename.isEmpty()) {
+        return;
+    }
+
+    ResizeParameters Parameters;
+    QString          Error;
+    int              Skipped = 0;
+    if (this->Model->loadSession(Filename, QSettings().value("Session/Validate", true).toBool(), &Parameters, &Skipped, &Error) == -1) {
+        QMessageBox::critical(this, MAIN_WINDOW_TITLE, tr("Couldn't load the list: %1").arg(Error), QMessageBox::Ok);
+        return;
+    }
+
+    // The spinboxes check their radio button, so the method is set last
+    ui->SpinboxPercentage->setValue(Parameters.Percentage);
+    ui->SpinboxAbsoluteSize->setValue(Parameters.AbsoluteSize);
+    ui->RadioPercentage->setChecked(Parameters.Method == ResizeParameters::MethodPercentage);
+    ui->RadioAbsoluteSize->setChecked(Parameters.Method == ResizeParameters::MethodAbsoluteSize);
+    this->ParametersTimer.stop();
+    updateAllSizes();
+    updateUI();
+
+    if (Skipped != 0) {
+        QMessageBox::information(this, MAIN_WINDOW_TITLE, tr("%1 files of the list don't exist anymore, they have been skipped.").arg(Skipped), QMessageBox::Ok);
+    }
+}
+
 //
 //  cancelTask
 //
@@ -21,15 +21,21 @@
 #ifndef MAINWINDOW_HPP
 #define MAINWINDOW_HPP
 
-#include <QByteArray>
+#include "../Core/ErrorLog.hpp"
+#include "../Core/ResizeJob.hpp"
+#include "../Core/ResizeOptions.hpp"
 #include <QCloseEvent>
 #include <QList>
 #include <QMainWindow>
 #include <QSize>
 #include <QStringList>
-#include <QTableWidget>
+#include <QTableView>
+#include <QTimer>
 #include <QUrl>
 
+class ResizeParameters;
+class TableModel;
+
 //
 //  MainWindow
 //
@@ -50,20 +56,28 @@ class MainWindow: public QMainWindow
 
   private:
     // UI
-    Ui::MainWindow*   ui;
-    QTableWidget*     Table;                  // Main table, contaning filenames and size informations
-    QList<QByteArray> SupportedExtensionList; // List of supported picture extension
-    QStringList       InvalidDroppedFiles;    // Files that cannot be processed when they are dropped into the UI
-    bool              CloseRequested;         // True if close is requested, preventing some dialogs to pop up
+    Ui::MainWindow*  ui;
+    QTableView*      Table;           // Main table, contaning filenames and size informations
+    TableModel*      Model;           // Data displayed by the main table
+    QTimer           ParametersTimer; // Debounce the resizing parameter changes
+    ErrorLog         DropErrors;      // Files that cannot be processed or exceed the limits when they are dropped into the UI
+    bool             CloseRequested;  // True if close is requested, preventing some dialogs to pop up
+    bool             ResizeOnDrop;    // Streaming mode: dropped files are resized as soon as they are probed
+    QList<ResizeJob> StreamBacklog;   // Jobs dropped while the streaming process was terminating, resized by the next one
 
-    void updateSize(QSize& orgsize, QSize& newsize);     // Compute the new dimensions of a picture, according to the selected resizing method
-    void updateAllSizes();                               // Update sizes displayed in the table
-    void updateUI();                                     // Update UI, depending on program state
-    void closeEvent(QCloseEvent* event) override;        // Intercept close event to allow program termination while a thread is running
-    void getFiles(QList<QUrl>& list, QUrl dirurl) const; // Return the list of the files contained in a directory
+    ResizeParameters resizeParameters() const;                // Return the resizing method selected in the UI
+    ResizeOptions    resizeOptions() const;                   // Return the engine settings, with the file size budget selected in the UI
+    void             scheduleSizesUpdate();                   // Update the new sizes once the user stops changing the parameters
+    void             updateAllSizes();                        // Give the current resizing method to the table
+    void             updateUI();                              // Update UI, depending on program state
+    void             enqueueNewJobs();                        // Streaming mode: resize the files which have not been queued yet
+    void             offerResume();                           // Offer to resize the files left unfinished by an interrupted run
+    void             closeEvent(QCloseEvent* event) override; // Intercept close event to allow program termination while a thread is running
 
     // Slots linked to UI
     void clearTable();                       // Remove all entries imported in the main table
+    void saveList();                         // Save the table and the resizing method to a session file
+    void loadList();                         // Add the files of a session file to the table, and restore its resizing method
     void cancelTask();                       // Cancel on the flight file dropping or resizing
     void onResizingMethodChanged();          // Called when resizing method changes, to refresh new sizes
     void onButtonResizeClicked();            // Start the main worker of this program
@@ -75,25 +89,10 @@ class MainWindow: public QMainWindow
     void onDropResultReady();                      // Triggered when picture data is ready to use
     void onDroppedFileProcessed(QString filename); // Triggered when processed file changes
     void onDropProcessTerminated();                // Triggered when all dropped files have been handled
-    void onFileResizing(QString filename);         // Triggered when a file resizing starts
-    void onFileResized();                          // Triggered when a file have been resized
+    void onFileResizing(int id, QString filename); // Triggered when a file resizing starts
+    void onFileResized(int id, bool success);      // Triggered when a file have been resized
     void onResizingTerminated();                   // Triggered when resizing of all files is done
     void onResizingAborted();                      // Trigerred when the resizing process is aborted by user
 };
 
-//
-//  Column index
-//
-
-#define COLUMN_FILENAME 0
-#define COLUMN_ORGSIZE  1
-#define COLUMN_NEWSIZE  2
-#define COLUMN_COUNT    3
-
-//
-// max() macro
-//
-
-#define max(a, b) (a < b ? b : a)
-
 #endif // MAINWINDOW_HPP
@@ -0,0 +1,788 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#include "TableModel.hpp"
+#include "../Core/SessionFile.hpp"
+#include "../Core/ThumbnailThread.hpp"
+#include <QPersistentModelIndex>
+#include <algorithm>
+#include <functional>
+
+//
+//  TableModel
+//
+// Constructor. The table is not sorted until the view asks for it
+//
+
+TableModel::TableModel(QObject* parent)
+    : QAbstractTableModel(parent)
+    , Hidden(0)
+    , SortColumn(-1)
+    , SortOrder(Qt::AscendingOrder)
+    , Thumbnails(THUMBNAIL_CACHE_SIZE)
+    , ThumbnailGeneration(0)
+{
+    // Job status updates are applied at most every 100 ms
+    this->FlushTimer.setSingleShot(true);
+    this->FlushTimer.setInterval(100);
+    connect(&this->FlushTimer, &QTimer::timeout, this, &TableModel::flushJobs);
+
+    // Thumbnails arrivals refresh the view at most every 50 ms. Only visible cells are repainted
+    this->ThumbnailTimer.setSingleShot(true);
+    this->ThumbnailTimer.setInterval(50);
+    connect(&this->ThumbnailTimer, &QTimer::timeout, [this]() {
+        if (rowCount() != 0) {
+            emit dataChanged(index(0, COLUMN_THUMBNAIL), index(rowCount() - 1, COLUMN_THUMBNAIL), {Qt::DecorationRole});
+        }
+    });
+
+    // Connect the thumbnail thread. Queued connections needed because of the different threads
+    connect(ThumbnailThread::instance(), &ThumbnailThread::thumbnailReady, this, &TableModel::onThumbnailReady, Qt::QueuedConnection);
+    connect(ThumbnailThread::instance(), &ThumbnailThread::thumbnailDiscarded, this, &TableModel::onThumbnailDiscarded, Qt::QueuedConnection);
+}
+
+//
+//  rowCount
+//
+// Return the number of displayed files
+//
+
+int TableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : this->Order.count() - this->Hidden;
+}
+
+//
+//  columnCount
+//
+// Return the number of columns of the table
+//
+
+int TableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+//
+//  data
+//
+// Return the data displayed in a cell. Strings are built on the fly, only for the visible cells
+//
+
+QVariant TableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || (index.row() >= rowCount())) {
+        return QVariant();
+    }
+
+    int Id = this->Order.at(position(index.row()));
+    switch (role) {
+        case Qt::DecorationRole:
+            // The view asks only for visible cells. Request the thumbnail if it's not known yet
+            if (index.column() == COLUMN_THUMBNAIL) {
+                QPixmap* Thumbnail = this->Thumbnails.object(Id);
+                if (Thumbnail != nullptr) {
+                    return Thumbnail->isNull() ? QVariant() : QVariant::fromValue(*Thumbnail);
+                }
+                if (!this->PendingThumbnails.contains(Id)) {
+                    this->PendingThumbnails.insert(Id);
+                    ThumbnailThread::instance()->request(Id, this->ThumbnailGeneration, this->Store.filename(Id));
+                }
+            }
+            break;
+
+        case Qt::DisplayRole:
+            if (index.column() == COLUMN_THUMBNAIL) {
+                return QVariant();
+            }
+            else if (index.column() == COLUMN_FILENAME) {
+                return this->Store.filename(Id);
+            }
+            else if (index.column() == COLUMN_STATUS) {
+                switch (this->Store.jobStatus(Id)) {
+                    case FileStore::StatusQueued:
+                        return tr("Queued");
+                    case FileStore::StatusRunning:
+                        return tr("Resizing");
+                    case FileStore::StatusDone:
+                        return tr("Done");
+                    case FileStore::StatusFailed:
+                        return tr("Failed");
+                    default:
+                        return QString();
+                }
+            }
+            else {
+                QSize Size = index.column() == COLUMN_ORGSIZE ? this->Store.orgSize(Id) : this->Parameters.newSize(this->Store.orgSize(Id));
+                return QString("%1 x %2").arg(Size.width()).arg(Size.height());
+            }
+
+        case Qt::TextAlignmentRole:
+            // Sizes and thumbnails are centered, filenames keep the default alignment
+            if (index.column() != COLUMN_FILENAME) {
+                return int(Qt::AlignCenter);
+            }
+            break;
+
+        case Qt::UserRole:
+            if (index.column() == COLUMN_ORGSIZE) {
+                return QVariant::fromValue(this->Store.orgSize(Id));
+            }
+            if (index.column() == COLUMN_NEWSIZE) {
+                return QVariant::fromValue(this->Parameters.newSize(this->Store.orgSize(Id)));
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return QVariant();
+}
+
+//
+//  headerData
+//
+// Return the column titles
+//
+
+QVariant TableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation != Qt::Horizontal) || (role != Qt::DisplayRole)) {
+        return QVariant();
+    }
+
+    switch (section) {
+        case COLUMN_THUMBNAIL:
+            return tr("Preview");
+        case COLUMN_FILENAME:
+            return tr("File name");
+        case COLUMN_ORGSIZE:
+            return tr("Actual size");
+        case COLUMN_NEWSIZE:
+            return tr("New size");
+        case COLUMN_STATUS:
+            return tr("Status");
+        default:
+            return QVariant();
+    }
+}
+
+//
+//  removeRows
+//
+// Remove files from the table. Their ids are released in the store, which is cleared when it becomes empty.
+// Their entries are only hidden in the display order, so a removal costs O(log n) per row, wherever the rows are.
+// The order is compacted when half of it is hidden, which keeps the amortized cost constant
+//
+
+bool TableModel::removeRows(int row, int count, const QModelIndex& parent)
+{
+    if (parent.isValid() || (row < 0) || (count <= 0) || (row + count > rowCount())) {
+        return false;
+    }
+
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    for (int i = 0; i < count; i++) {
+        // The next row takes the place of the hidden one
+        int Position = position(row);
+        this->Store.release(this->Order.at(Position));
+        hide(Position);
+    }
+    if (this->Store.liveCount() == 0) {
+        resetStore();
+    }
+    else if (this->Hidden * 2 > this->Order.count()) {
+        compact();
+    }
+    endRemoveRows();
+
+    return true;
+}
+
+//
+//  sort
+//
+// Called by the view when a column header is clicked. Sort keys are numeric for the size columns
+//
+
+void TableModel::sort(int column, Qt::SortOrder order)
+{
+    this->SortColumn = column;
+    this->SortOrder  = order;
+    applySort(0);
+}
+
+//
+//  store
+//
+// Give a read-only access to the underlying storage
+//
+
+const FileStore& TableModel::store() const
+{
+    return this->Store;
+}
+
+//
+//  append
+//
+// Add files at the end of the table, or at their sorted position if the table is sorted.
+// Files already present are silently discarded
+//
+
+int TableModel::append(const QList<QPair<QString, QSize>>& files)
+{
+    QVector<quint32> Ids;
+    Ids.reserve(files.count());
+    this->Store.reserve(this->Store.count() + files.count());
+
+    for (int i = 0; i < files.count(); i++) {
+        int Id = this->Store.append(files.at(i).first, files.at(i).second);
+        if (Id != -1) {
+            Ids << quint32(Id);
+        }
+    }
+
+    appendRows(Ids);
+    return Ids.count();
+}
+
+//
+//  appendRows
+//
+// Display files newly added to the store after the existing rows. If the table is sorted, they are merged at their place
+//
+
+void TableModel::appendRows(const QVector<quint32>& ids)
+{
+    if (!ids.isEmpty()) {
+        // Sorting works on rows: positions must match them
+        if (this->SortColumn != -1) {
+            compact();
+        }
+
+        int First = rowCount();
+        beginInsertRows(QModelIndex(), First, First + ids.count() - 1);
+        int FirstPosition = this->Order.count();
+        this->Order << ids;
+        this->Unqueued << ids;
+        extendIndex(FirstPosition);
+        endInsertRows();
+
+        if (this->SortColumn != -1) {
+            applySort(First);
+        }
+    }
+}
+
+//
+//  saveSession
+//
+// Save the files in display order, with the resizing parameters used to compute the new sizes. Hidden entries are skipped
+//
+
+bool TableModel::saveSession(const QString& filename, QString* error) const
+{
+    QVector<quint32> Ids;
+    Ids.reserve(rowCount());
+    for (int i = 0; i < this->Order.count(); i++) {
+        if (!this->Store.isReleased(this->Order.at(i))) {
+            Ids << this->Order.at(i);
+        }
+    }
+    return SessionFile::save(filename, this->Store, Ids, this->Parameters, error);
+}
+
+//
+//  loadSession
+//
+// Add the files of a session, without probing them. The parameters of the session are given back, it's up to the caller to apply them.
+// If validate is true, the files which don't exist anymore are skipped. Return the number of files added, or -1 if the session couldn't be read
+//
+
+int TableModel::loadSession(const QString& filename, bool validate, ResizeParameters* parameters, int* skipped, QString* error)
+{
+    QVector<quint32> Ids;
+    if (!SessionFile::load(filename, &this->Store, &Ids, parameters, validate, skipped, error)) {
+        return -1;
+    }
+    appendRows(Ids);
+    return Ids.count();
+}
+
+//
+//  clear
+//
+// Remove all the files from the table
+//
+
+void TableModel::clear()
+{
+    beginResetModel();
+    this->FlushTimer.stop();
+    resetStore();
+    this->Order.squeeze();
+    endResetModel();
+}
+
+//
+//  id
+//
+// Return the store id of the file displayed at a given row
+//
+
+int TableModel::id(int row) const
+{
+    return this->Order.at(position(row));
+}
+
+//
+//  filename
+//
+// Return the full path of the file displayed at a given row
+//
+
+QString TableModel::filename(int row) const
+{
+    return this->Store.filename(this->Order.at(position(row)));
+}
+
+//
+//  orgSize
+//
+// Return the original size of the file displayed at a given row
+//
+
+QSize TableModel::orgSize(int row) const
+{
+    return this->Store.orgSize(this->Order.at(position(row)));
+}
+
+//
+//  newSize
+//
+// Return the new size of the file displayed at a given row. It's computed from the current parameters
+//
+
+QSize TableModel::newSize(int row) const
+{
+    return this->Parameters.newSize(this->Store.orgSize(this->Order.at(position(row))));
+}
+
+//
+//  resizeParameters
+//
+// Return the parameters used to compute new sizes
+//
+
+ResizeParameters TableModel::resizeParameters() const
+{
+    return this->Parameters;
+}
+
+//
+//  setResizeParameters
+//
+// Change the resizing method. Nothing is computed here: the view only asks for the visible cells.
+// Rows are reordered if the table is sorted by new size
+//
+
+void TableModel::setResizeParameters(const ResizeParameters& parameters)
+{
+    if (parameters == this->Parameters) {
+        return;
+    }
+
+    this->Parameters = parameters;
+    if (rowCount() != 0) {
+        emit dataChanged(index(0, COLUMN_NEWSIZE), index(rowCount() - 1, COLUMN_NEWSIZE));
+        if (this->SortColumn == COLUMN_NEWSIZE) {
+            applySort(0);
+        }
+    }
+}
+
+//
+//  queueJobs
+//
+// Mark every file as queued, and return the list of jobs in display order. This is where new sizes are materialized.
+// If newonly is true, only the files added or reset since the last call are considered, in the order they were added:
+// in streaming mode, the cost of a batch depends on its size, not on the size of the table
+//
+
+QList<ResizeJob> TableModel::queueJobs(bool newonly)
+{
+    const QVector<quint32>& Ids = newonly ? this->Unqueued : this->Order;
+    QList<ResizeJob>        Jobs;
+    Jobs.reserve(Ids.count());
+    for (int i = 0; i < Ids.count(); i++) {
+        int Id = Ids.at(i);
+        if (this->Store.isReleased(Id) || (newonly && (this->Store.jobStatus(Id) != FileStore::StatusNone))) {
+            continue;
+        }
+        QSize OrgSize = this->Store.orgSize(Id);
+        this->Store.setJobStatus(Id, FileStore::StatusQueued);
+        Jobs << ResizeJob {Id, this->Store.filename(Id), OrgSize, this->Parameters.newSize(OrgSize)};
+    }
+    this->Unqueued.clear();
+
+    if (rowCount() != 0) {
+        emit dataChanged(index(0, COLUMN_STATUS), index(rowCount() - 1, COLUMN_STATUS));
+    }
+    return Jobs;
+}
+
+//
+//  setJobStatus
+//
+// Update the status of a job. This is O(1): the view is refreshed and the done rows are removed
+// by flushJobs(), which is triggered at most every 100 ms whatever the number of finished files
+//
+
+void TableModel::setJobStatus(int id, FileStore::JobStatus status)
+{
+    if ((id < 0) || (id >= this->Store.count()) || this->Store.isReleased(id)) {
+        return;
+    }
+
+    if ((status == FileStore::StatusDone) && (this->Store.jobStatus(id) != FileStore::StatusDone)) {
+        this->Finished << quint32(id);
+    }
+    this->Store.setJobStatus(id, status);
+
+    if (!this->FlushTimer.isActive()) {
+        this->FlushTimer.start();
+    }
+}
+
+//
+//  flushJobs
+//
+// Remove the rows of the jobs done since the last flush, and refresh the Status column.
+// Only the finished files are looked at: their rows are found from their ids, then grouped in contiguous ranges,
+// each range being removed at once. The cost is O(log n) per finished file, whatever the table size and the rows order
+//
+
+void TableModel::flushJobs()
+{
+    this->FlushTimer.stop();
+
+    if (!this->Finished.isEmpty()) {
+        QVector<int> Rows;
+        Rows.reserve(this->Finished.count());
+        for (int i = 0; i < this->Finished.count(); i++) {
+            quint32 Id = this->Finished.at(i);
+            if (!this->Store.isReleased(Id) && (this->Store.jobStatus(Id) == FileStore::StatusDone)) {
+                Rows << rowAt(this->Positions.at(Id));
+            }
+        }
+        this->Finished.clear();
+
+        // Remove the ranges starting from the end, to keep row numbers valid
+        std::sort(Rows.begin(), Rows.end(), std::greater<int>());
+        Rows.erase(std::unique(Rows.begin(), Rows.end()), Rows.end());
+        for (int i = 0; i < Rows.count();) {
+            int Last  = Rows.at(i);
+            int First = Last;
+            for (i++; (i < Rows.count()) && (Rows.at(i) == First - 1); i++) {
+                First--;
+            }
+            removeRows(First, Last - First + 1);
+        }
+    }
+
+    // Only visible cells are actually repainted
+    if (rowCount() != 0) {
+        emit dataChanged(index(0, COLUMN_STATUS), index(rowCount() - 1, COLUMN_STATUS));
+    }
+}
+
+//
+//  resetJobs
+//
+// Called when a resizing process is interrupted: files which were not processed go back to the idle state
+//
+
+void TableModel::resetJobs()
+{
+    flushJobs();
+    for (int i = 0; i < this->Order.count(); i++) {
+        int Id = this->Order.at(i);
+        if (!this->Store.isReleased(Id) && ((this->Store.jobStatus(Id) == FileStore::StatusQueued) || (this->Store.jobStatus(Id) == FileStore::StatusRunning))) {
+            this->Store.setJobStatus(Id, FileStore::StatusNone);
+            this->Unqueued << quint32(Id);
+        }
+    }
+
+    if (rowCount() != 0) {
+        emit dataChanged(index(0, COLUMN_STATUS), index(rowCount() - 1, COLUMN_STATUS));
+    }
+}
+
+//
+//  lessThan
+//
+// Return true if id1 must be displayed before id2, according to the sort column and order
+//
+
+bool TableModel::lessThan(quint32 id1, quint32 id2) const
+{
+    if (this->SortOrder == Qt::DescendingOrder) {
+        std::swap(id1, id2);
+    }
+
+    switch (this->SortColumn) {
+        case COLUMN_ORGSIZE: {
+            qint64 Pixels1 = this->Store.orgPixels(id1);
+            qint64 Pixels2 = this->Store.orgPixels(id2);
+            return Pixels1 != Pixels2 ? Pixels1 < Pixels2 : this->Store.orgSize(id1).width() < this->Store.orgSize(id2).width();
+        }
+
+        case COLUMN_NEWSIZE: {
+            QSize  Size1   = this->Parameters.newSize(this->Store.orgSize(id1));
+            QSize  Size2   = this->Parameters.newSize(this->Store.orgSize(id2));
+            qint64 Pixels1 = qint64(Size1.width()) * Size1.height();
+            qint64 Pixels2 = qint64(Size2.width()) * Size2.height();
+            return Pixels1 != Pixels2 ? Pixels1 < Pixels2 : Size1.width() < Size2.width();
+        }
+
+        default:
+            return this->Store.compareFilenames(id1, id2) < 0;
+    }
+}
+
+//
+//  applySort
+//
+// Sort the rows [first, end[, then merge them with the rows [0, first[ which are already sorted.
+// Merging a batch of new rows is linear, so appending files to a sorted table stays cheap.
+// Hidden entries are dropped first, so rows and positions match. Persistent indexes (selection, current item) follow their files
+//
+
+void TableModel::applySort(int first)
+{
+    if (this->SortColumn < 0 || rowCount() - first < 1) {
+        return;
+    }
+    compact();
+
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+
+    // Remember which file each persistent index points to
+    QModelIndexList  OldIndexes = persistentIndexList();
+    QVector<quint32> OldIds;
+    OldIds.reserve(OldIndexes.count());
+    for (int i = 0; i < OldIndexes.count(); i++) {
+        OldIds << this->Order.at(OldIndexes.at(i).row());
+    }
+
+    // Sort the new rows, then merge them
+    auto LessThan = [this](quint32 id1, quint32 id2) { return lessThan(id1, id2); };
+    std::stable_sort(this->Order.begin() + first, this->Order.end(), LessThan);
+    if (first != 0) {
+        std::inplace_merge(this->Order.begin(), this->Order.begin() + first, this->Order.end(), LessThan);
+    }
+
+    // Every entry is visible, so the Fenwick tree doesn't change. Only the positions of the ids do
+    for (int i = 0; i < this->Order.count(); i++) {
+        this->Positions[this->Order.at(i)] = i;
+    }
+
+    // Update the persistent indexes
+    if (!OldIndexes.isEmpty()) {
+        QModelIndexList NewIndexes;
+        NewIndexes.reserve(OldIndexes.count());
+        for (int i = 0; i < OldIndexes.count(); i++) {
+            NewIndexes << index(this->Positions.at(OldIds.at(i)), OldIndexes.at(i).column());
+        }
+        changePersistentIndexList(OldIndexes, NewIndexes);
+    }
+
+    emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+}
+
+//
+//  resetStore
+//
+// Clear the store and the display order. As ids will be reused, cached thumbnails and pending requests are discarded,
+// and thumbnails still in flight will be ignored thanks to the generation number
+//
+
+void TableModel::resetStore()
+{
+    this->Store.clear();
+    this->Order.clear();
+    this->Tree.clear();
+    this->Positions.clear();
+    this->Hidden = 0;
+    this->Finished.clear();
+    this->Unqueued.clear();
+    this->Thumbnails.clear();
+    this->PendingThumbnails.clear();
+    this->ThumbnailGeneration++;
+    ThumbnailThread::instance()->cancel();
+}
+
+//
+//  position
+//
+// Return the position in Order of the entry displayed at a row. Without hidden entries, they are the same.
+// Otherwise, the Fenwick tree is descended to find the entry preceded by row visible entries, in O(log n)
+//
+
+int TableModel::position(int row) const
+{
+    if (this->Hidden == 0) {
+        return row;
+    }
+
+    int Step = 1;
+    while (Step * 2 <= this->Order.count()) {
+        Step *= 2;
+    }
+
+    int Index     = 0;
+    int Remaining = row + 1;
+    for (; Step > 0; Step /= 2) {
+        int Next = Index + Step;
+        if ((Next <= this->Order.count()) && (this->Tree.at(Next) < Remaining)) {
+            Index      = Next;
+            Remaining -= this->Tree.at(Next);
+        }
+    }
+    return Index;
+}
+
+//
+//  rowAt
+//
+// Return the row of a visible entry: the number of visible entries before its position, in O(log n)
+//
+
+int TableModel::rowAt(int position) const
+{
+    if (this->Hidden == 0) {
+        return position;
+    }
+
+    int Row = 0;
+    for (int i = position; i > 0; i -= i & -i) {
+        Row += this->Tree.at(i);
+    }
+    return Row;
+}
+
+//
+//  hide
+//
+// Hide an entry of Order, whose file has been released. The rows after it move up
+//
+
+void TableModel::hide(int position)
+{
+    for (int i = position + 1; i < this->Tree.count(); i += i & -i) {
+        this->Tree[i]--;
+    }
+    this->Hidden++;
+}
+
+//
+//  extendIndex
+//
+// Index the entries appended to Order from a given position. Each node of the Fenwick tree is the sum
+// of the nodes it covers, so appending is O(log n) per entry and the existing nodes don't change
+//
+
+void TableModel::extendIndex(int first)
+{
+    this->Tree.resize(this->Order.count() + 1);
+    this->Positions.resize(this->Store.count());
+    for (int p = first; p < this->Order.count(); p++) {
+        quint32 Id    = this->Order.at(p);
+        int     Index = p + 1;
+        int     Count = this->Store.isReleased(Id) ? 0 : 1;
+        for (int i = Index - 1; i > Index - (Index & -Index); i -= i & -i) {
+            Count += this->Tree.at(i);
+        }
+        this->Tree[Index]   = Count;
+        this->Positions[Id] = p;
+        this->Hidden       += this->Store.isReleased(Id) ? 1 : 0;
+    }
+}
+
+//
+//  compact
+//
+// Drop the hidden entries from Order and rebuild the index. Rows don't change, so the view is not notified
+//
+
+void TableModel::compact()
+{
+    if (this->Hidden == 0) {
+        return;
+    }
+
+    QVector<quint32> Visible;
+    Visible.reserve(rowCount());
+    for (int i = 0; i < this->Order.count(); i++) {
+        if (!this->Store.isReleased(this->Order.at(i))) {
+            Visible << this->Order.at(i);
+        }
+    }
+    this->Order  = Visible;
+    this->Hidden = 0;
+    this->Tree.clear();
+    extendIndex(0);
+}
+
+//
+//  onThumbnailReady
+//
+// Slot called when a thumbnail has been loaded. A null thumbnail is cached too, to avoid loading an unreadable file again
+//
+
+void TableModel::onThumbnailReady(int id, int generation, QImage thumbnail)
+{
+    if (generation != this->ThumbnailGeneration) {
+        return;
+    }
+
+    this->PendingThumbnails.remove(id);
+    int Cost = qMax(1, int(thumbnail.sizeInBytes() / 1024));
+    this->Thumbnails.insert(id, new QPixmap(QPixmap::fromImage(thumbnail)), Cost);
+
+    if (!this->ThumbnailTimer.isActive()) {
+        this->ThumbnailTimer.start();
+    }
+}
+
+//
+//  onThumbnailDiscarded
+//
+// Slot called when a thumbnail request has been dropped by the thread. It will be requested again if the row is displayed
+//
+
+void TableModel::onThumbnailDiscarded(int id, int generation)
+{
+    if (generation == this->ThumbnailGeneration) {
+        this->PendingThumbnails.remove(id);
+    }
+}
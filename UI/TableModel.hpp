@@ -0,0 +1,141 @@
+/*
+ * PicRes - GUI program to resize pictures in an easy way
+ * Copyright (C) 2020-2025 Martial Demolins AKA Folco
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * mail: martial <dot> demolins <at> gmail <dot> com
+ */
+
+#ifndef TABLEMODEL_HPP
+#define TABLEMODEL_HPP
+
+#include "../Core/FileStore.hpp"
+#include "../Core/ResizeJob.hpp"
+#include "../Core/ResizeParameters.hpp"
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QImage>
+#include <QList>
+#include <QModelIndex>
+#include <QPair>
+#include <QPixmap>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <QTimer>
+#include <QVariant>
+#include <QVector>
+
+//
+//  Column index
+//
+
+#define COLUMN_THUMBNAIL 0
+#define COLUMN_FILENAME  1
+#define COLUMN_ORGSIZE   2
+#define COLUMN_NEWSIZE   3
+#define COLUMN_STATUS    4
+#define COLUMN_COUNT     5
+
+//
+//  Memory used by the thumbnails kept in memory, in KB
+//
+
+#define THUMBNAIL_CACHE_SIZE (64 * 1024)
+
+//
+//  TableModel
+//
+// This class is the model displayed by the main table. Data is held by a FileStore,
+// the model only keeps the display order of the store ids.
+// New sizes are computed when the view asks for them, so only visible rows cost something.
+// Job status changes are coalesced: finished rows are removed by batches, not one by one.
+// Removed files are only hidden in the display order: a Fenwick tree counts the visible entries, so a row is found
+// and removed in O(log n), and the order is compacted once half of it is hidden.
+// Thumbnails are requested asynchronously, for the visible rows only, and kept in a bounded LRU cache
+//
+
+class TableModel: public QAbstractTableModel
+{
+    Q_OBJECT
+
+  public:
+    explicit TableModel(QObject* parent = nullptr);
+
+    // QAbstractTableModel interface
+    int      rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int      columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool     removeRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
+    void     sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    // Data access
+    const FileStore& store() const;                                           // Underlying storage
+    int              append(const QList<QPair<QString, QSize>>& files);       // Add files, discarding duplicates. Return the number of files added
+    void             clear();                                                 // Remove all files
+    int              id(int row) const;                                       // Store id of the file displayed at a row
+    QString          filename(int row) const;                                 // Full path of the file displayed at a row
+    QSize            orgSize(int row) const;                                  // Original size of the file displayed at a row
+    QSize            newSize(int row) const;                                  // New size of the file displayed at a row, computed on demand
+    ResizeParameters resizeParameters() const;                                // Parameters used to compute new sizes
+    void             setResizeParameters(const ResizeParameters& parameters); // Change the parameters and refresh the New size column
+
+    // Session files
+    bool saveSession(const QString& filename, QString* error) const;                                                      // Save the files in display order, with the resizing parameters
+    int  loadSession(const QString& filename, bool validate, ResizeParameters* parameters, int* skipped, QString* error); // Add the files of a session. Return the number of files added, -1 on failure
+
+    // Resizing jobs. The job id of a file is its store id
+    QList<ResizeJob> queueJobs(bool newonly = false);                   // Mark the files as queued and return their jobs, new sizes computed
+    void             setJobStatus(int id, FileStore::JobStatus status); // Update the status of a job. Done rows are removed later, in batch
+    void             flushJobs();                                       // Remove the done rows and refresh the Status column now
+    void             resetJobs();                                       // Forget the status of unfinished jobs
+
+  private:
+    bool lessThan(quint32 id1, quint32 id2) const; // Compare two files according to the current sort column and order
+    void applySort(int first);                     // Sort the rows [first, end[ and merge them into the already sorted rows
+    void appendRows(const QVector<quint32>& ids);  // Display new store ids after the existing rows, sorted if needed
+    void resetStore();                             // Clear the store. Ids will be reused, so forget everything related to them
+
+    // Row map
+    int  position(int row) const;   // Position in Order of the entry displayed at a row
+    int  rowAt(int position) const; // Row of a visible entry, i.e. number of visible entries before it
+    void hide(int position);        // Hide an entry whose file has been released
+    void extendIndex(int first);    // Index the entries [first, end[ of Order, just appended
+    void compact();                 // Drop the hidden entries from Order, and rebuild the index
+
+    // Slots linked to the thumbnail thread
+    void onThumbnailReady(int id, int generation, QImage thumbnail); // Put a thumbnail in the cache
+    void onThumbnailDiscarded(int id, int generation);               // A request has been dropped, it may be done again
+
+    FileStore        Store;      // Files data
+    QVector<quint32> Order;      // Store ids, in display order. Released ids are hidden entries
+    QVector<int>     Tree;       // Fenwick tree counting the visible entries of Order, 1-based
+    QVector<int>     Positions;  // Position in Order of each store id
+    int              Hidden;     // Number of hidden entries in Order
+    int              SortColumn; // Column used to sort the rows, -1 if the table is not sorted
+    Qt::SortOrder    SortOrder;  // Order used to sort the rows
+    ResizeParameters Parameters; // Resizing method used to compute new sizes
+    QTimer           FlushTimer; // Coalesce job status updates
+    QVector<quint32> Finished;   // Ids of the jobs done since the last flush, whose row has not been removed yet
+    QVector<quint32> Unqueued;   // Ids of the files added or reset since the last queueing, so streaming doesn't scan the table
+
+    mutable QCache<int, QPixmap> Thumbnails;          // LRU cache of the loaded thumbnails, indexed by id. Cost is in KB
+    mutable QSet<int>            PendingThumbnails;   // Ids whose thumbnail has been requested
+    int                          ThumbnailGeneration; // Incremented when ids are reused, to discard late thumbnails
+    QTimer                       ThumbnailTimer;      // Coalesce thumbnail arrivals
+};
+
+#endif // TABLEMODEL_HPP
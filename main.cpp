@@ -18,21 +18,43 @@
  * mail: martial <dot> demolins <at> gmail <dot> com
  */
 
+#include "Core/BatchRunner.hpp"
+#include "Core/TraceRecorder.hpp"
+#include "Core/WorkerProcess.hpp"
 #include "UI/MainWindow.hpp"
 #include <QApplication>
+#include <QCoreApplication>
 #include <QGuiApplication>
 #include <QIcon>
+#include <QSettings>
 
 //  main
 //
-// Create the MainWindow, show it and execute it
+// Create the MainWindow, show it and execute it.
+// When started by PicRes itself to resize pictures in a separate process, run the worker loop instead.
+// When started with --batch, resize the files given on the command line without GUI.
+// If the Trace/File setting is set, the timeline of the workers is written to this file when the program exits
 //
 
 int main(int argc, char* argv[])
 {
+    // Settings are shared by all modes
+    QCoreApplication::setOrganizationName("Folco");
+    QCoreApplication::setApplicationName("PicRes");
+
+    if (WorkerProcess::isWorker(argc, argv)) {
+        return WorkerProcess::exec(argc, argv);
+    }
+    if (BatchRunner::isBatch(argc, argv)) {
+        return BatchRunner::exec(argc, argv);
+    }
+
     QApplication Application(argc, argv);
     QGuiApplication::setWindowIcon(QIcon(":/Main/Icon.png"));
+    TraceRecorder::start(QSettings().value("Trace/File").toString());
     MainWindow Window(argc, argv); // Handle files dropped on the program icon (or passed from CLI)
     Window.show();
-    return Application.exec();
+    int Result = Application.exec();
+    TraceRecorder::stop();
+    return Result;
 }